@@ -0,0 +1,115 @@
+// Unit Includes
+#include "block-codec.h"
+
+// Project Includes
+#include "fastdxt-codec.h"
+#include "squish-codec.h"
+#include "etc2comp-codec.h"
+#include "etcdec-codec.h"
+#include "rangefit-codec.h"
+
+// Standard Library Includes
+#include <algorithm>
+
+//===============================================================================================================
+// UNIT ONLY
+//===============================================================================================================
+namespace
+{
+    QStringList codecNames(bool (BlockCodec::*handles)(KTex::Header::PixelFormat) const)
+    {
+        using enum KTex::Header::PixelFormat;
+
+        // Local, as this is used while initializing other statics (e.g. command descriptions)
+        static const QList<KTex::Header::PixelFormat> pixelFormats{DXT1, DXT3, DXT5, RGBA, RGB, ETC2EAC};
+
+        QStringList names;
+        for(const BlockCodec* codec : BlockCodec::all())
+            if(std::any_of(pixelFormats.cbegin(), pixelFormats.cend(), [&](auto format){ return (codec->*handles)(format); }))
+                names.append(codec->name());
+
+        return names;
+    }
+}
+
+//===============================================================================================================
+// BlockCodec
+//===============================================================================================================
+
+//-Class Functions----------------------------------------------------------------------------------------------
+//Public:
+const QList<const BlockCodec*>& BlockCodec::all()
+{
+    // In order of preference
+    static const FastDxtCodec fastDxt;
+    static const SquishCodec squish;
+    static const EtcDecCodec etcDec;
+    static const Etc2CompCodec etc2comp;
+    static const RangeFitCodec rangeFit;
+    static const QList<const BlockCodec*> codecs{&fastDxt, &squish, &etcDec, &etc2comp, &rangeFit};
+
+    return codecs;
+}
+
+const BlockCodec* BlockCodec::named(const QString& name)
+{
+    for(const BlockCodec* codec : all())
+        if(codec->name() == name)
+            return codec;
+
+    return nullptr;
+}
+
+const BlockCodec* BlockCodec::preferredEncoder(KTex::Header::PixelFormat format)
+{
+    for(const BlockCodec* codec : all())
+        if(codec->encodes(format))
+            return codec;
+
+    return nullptr;
+}
+
+const BlockCodec* BlockCodec::preferredDecoder(KTex::Header::PixelFormat format)
+{
+    for(const BlockCodec* codec : all())
+        if(codec->decodes(format))
+            return codec;
+
+    return nullptr;
+}
+
+QStringList BlockCodec::encoderNames() { return codecNames(&BlockCodec::encodes); }
+QStringList BlockCodec::decoderNames() { return codecNames(&BlockCodec::decodes); }
+
+//-Instance Functions--------------------------------------------------------------------------------------------
+//Public:
+QString BlockCodec::kernel() const { return u"scalar"_s; }
+QString BlockCodec::libraryVersion() const { return QString(); }
+bool BlockCodec::encodes(KTex::Header::PixelFormat format) const { Q_UNUSED(format); return false; }
+bool BlockCodec::decodes(KTex::Header::PixelFormat format) const { Q_UNUSED(format); return false; }
+
+void BlockCodec::encode(const uchar* rgba, int width, int height, int pitch, uchar* blocks,
+                        KTex::Header::PixelFormat format, Quality quality, bool grayscale) const
+{
+    Q_UNUSED(rgba);
+    Q_UNUSED(width);
+    Q_UNUSED(height);
+    Q_UNUSED(pitch);
+    Q_UNUSED(blocks);
+    Q_UNUSED(format);
+    Q_UNUSED(quality);
+    Q_UNUSED(grayscale);
+    qCritical("Codec cannot encode!");
+}
+
+void BlockCodec::decode(const uchar* blocks, int width, int height, uchar* rgba, int pitch,
+                        KTex::Header::PixelFormat format) const
+{
+    Q_UNUSED(blocks);
+    Q_UNUSED(width);
+    Q_UNUSED(height);
+    Q_UNUSED(rgba);
+    Q_UNUSED(pitch);
+    Q_UNUSED(format);
+    qCritical("Codec cannot decode!");
+}
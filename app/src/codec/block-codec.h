@@ -0,0 +1,62 @@
+#ifndef BLOCK_CODEC_H
+#define BLOCK_CODEC_H
+
+// Qt Includes
+#include <QString>
+#include <QList>
+#include <QStringList>
+
+// Project Includes
+#include "klei/k-tex.h"
+
+/* Interface for the encoders/decoders of the block compressed pixel formats. Each works on whole rows of 4x4
+ * blocks at a time so that the converters can split images into bands and process them concurrently.
+ *
+ * Implementations are registered in BlockCodec::all() in order of preference, which is used to pick a codec
+ * for a format when one isn't requested explicitly.
+ */
+class BlockCodec
+{
+//-Class Enums------------------------------------------------------------------------------------------------------
+public:
+    enum class Quality
+    {
+        Fast,
+        Normal,
+        Best
+    };
+
+//-Destructor-------------------------------------------------------------------------------------------------------
+public:
+    virtual ~BlockCodec() = default;
+
+//-Class Functions--------------------------------------------------------------------------------------------------
+public:
+    static const QList<const BlockCodec*>& all();
+    static const BlockCodec* named(const QString& name);
+    static const BlockCodec* preferredEncoder(KTex::Header::PixelFormat format);
+    static const BlockCodec* preferredDecoder(KTex::Header::PixelFormat format);
+    static QStringList encoderNames(); // Codecs that can encode at least one pixel format
+    static QStringList decoderNames(); // Codecs that can decode at least one pixel format
+
+//-Instance Functions----------------------------------------------------------------------------------------------
+public:
+    virtual QString name() const = 0;
+    virtual QString kernel() const; // Instruction set the codec runs on this machine
+    virtual QString libraryVersion() const; // Version of the external library behind the codec, if any
+    virtual int bandBlockRows() const = 0; // Rows of blocks worth processing as one unit of work
+
+    virtual bool encodes(KTex::Header::PixelFormat format) const;
+    virtual bool decodes(KTex::Header::PixelFormat format) const;
+
+    // Input rows are RGBA8 and 'pitch' bytes apart, output blocks are tightly packed. 'grayscale' describes the
+    // whole image rather than just the given rows, so that every band is encoded the same way
+    virtual void encode(const uchar* rgba, int width, int height, int pitch, uchar* blocks,
+                        KTex::Header::PixelFormat format, Quality quality, bool grayscale) const;
+
+    // Output rows are RGBA8 and 'pitch' bytes apart, input blocks are tightly packed
+    virtual void decode(const uchar* blocks, int width, int height, uchar* rgba, int pitch,
+                        KTex::Header::PixelFormat format) const;
+};
+
+#endif // BLOCK_CODEC_H
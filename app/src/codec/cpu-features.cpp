@@ -0,0 +1,67 @@
+// Unit Includes
+#include "cpu-features.h"
+
+// System Includes
+#if defined(STEX_X86) && defined(_MSC_VER)
+    #include <intrin.h>
+    #include <immintrin.h>
+#endif
+
+//===============================================================================================================
+// UNIT ONLY
+//===============================================================================================================
+namespace
+{
+    struct Features
+    {
+        bool sse2 = false;
+        bool ssse3 = false;
+        bool avx2 = false;
+    };
+
+    Features detect()
+    {
+        Features features;
+#if defined(STEX_X86) && defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 0);
+        int maxLeaf = info[0];
+
+        __cpuid(info, 1);
+        features.sse2 = info[3] & (1 << 26);
+        features.ssse3 = info[2] & (1 << 9);
+
+        // AVX state must also be enabled by the OS
+        bool osxsave = info[2] & (1 << 27);
+        bool avx = info[2] & (1 << 28);
+        if(maxLeaf >= 7 && osxsave && avx && (_xgetbv(0) & 0x6) == 0x6)
+        {
+            __cpuidex(info, 7, 0);
+            features.avx2 = info[1] & (1 << 5);
+        }
+#elif defined(STEX_X86)
+        // These account for OS support as well
+        __builtin_cpu_init();
+        features.sse2 = __builtin_cpu_supports("sse2");
+        features.ssse3 = __builtin_cpu_supports("ssse3");
+        features.avx2 = __builtin_cpu_supports("avx2");
+#endif
+        return features;
+    }
+
+    const Features& host()
+    {
+        static const Features features = detect();
+        return features;
+    }
+}
+
+//===============================================================================================================
+// CpuFeatures
+//===============================================================================================================
+
+//-Class Functions----------------------------------------------------------------------------------------------
+//Public:
+bool CpuFeatures::hasSse2() { return host().sse2; }
+bool CpuFeatures::hasSsse3() { return host().ssse3; }
+bool CpuFeatures::hasAvx2() { return host().avx2; }
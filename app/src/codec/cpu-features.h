@@ -0,0 +1,32 @@
+#ifndef CPU_FEATURES_H
+#define CPU_FEATURES_H
+
+// Architecture
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    #define STEX_X86
+#endif
+
+// SSE2 is part of the x86-64 baseline, so it can be used unconditionally there
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define STEX_SSE2
+#endif
+
+// Mark functions that use SSSE3/AVX2 intrinsics; they must only be called once the matching CpuFeatures check passes
+#if defined(STEX_X86) && (defined(__GNUC__) || defined(__clang__))
+    #define STEX_TARGET_SSSE3 __attribute__((target("ssse3")))
+    #define STEX_TARGET_AVX2 __attribute__((target("avx2")))
+#elif defined(STEX_X86)
+    #define STEX_TARGET_SSSE3 // MSVC allows any intrinsic without flags
+    #define STEX_TARGET_AVX2
+#endif
+
+class CpuFeatures
+{
+//-Class Functions--------------------------------------------------------------------------------------------------
+public:
+    static bool hasSse2();
+    static bool hasSsse3();
+    static bool hasAvx2();
+};
+
+#endif // CPU_FEATURES_H
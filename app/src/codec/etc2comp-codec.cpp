@@ -0,0 +1,103 @@
+// Unit Includes
+#include "etc2comp-codec.h"
+
+// Qt Includes
+#include <QByteArray>
+
+// Standard Library Includes
+#include <cstring>
+
+// etc2comp Includes
+#include <Etc/EtcImage.h>
+
+// Project Includes
+#include "project_vars.h"
+
+//===============================================================================================================
+// UNIT ONLY
+//===============================================================================================================
+namespace
+{
+    float getEtcEffort(BlockCodec::Quality quality)
+    {
+        // (0-100), Kram uses 49 by default and states that unity uses "80"
+        switch(quality)
+        {
+            case BlockCodec::Quality::Fast:
+                return 40;
+
+            case BlockCodec::Quality::Best:
+                return 100;
+
+            default:
+                return 90;
+        }
+    }
+}
+
+//===============================================================================================================
+// Etc2CompCodec
+//===============================================================================================================
+
+//-Instance Functions--------------------------------------------------------------------------------------------
+//Public:
+QString Etc2CompCodec::name() const { return u"etc2comp"_s; }
+QString Etc2CompCodec::libraryVersion() const { return QString::fromLatin1(PROJECT_ETC2COMP_VERSION_STR); }
+int Etc2CompCodec::bandBlockRows() const { return 4; } // ETC is far slower per block
+bool Etc2CompCodec::encodes(KTex::Header::PixelFormat format) const { return format == KTex::Header::PixelFormat::ETC2EAC; }
+bool Etc2CompCodec::decodes(KTex::Header::PixelFormat format) const { return encodes(format); }
+
+void Etc2CompCodec::encode(const uchar* rgba, int width, int height, int pitch, uchar* blocks,
+                           KTex::Header::PixelFormat format, Quality quality, bool grayscale) const
+{
+    Q_UNUSED(format);
+
+    // Get texture info
+    auto etcFormat = Etc::Image::Format::RGBA8; // Make function for this, like for squish, if more ETC formats are supported
+    auto errMetric = grayscale ? Etc::ErrorMetric::GRAY : Etc::ErrorMetric::NUMERIC; // Could try the Rec 709 option for color
+
+    /* The standard allows viewing a POD struct as a sequence of bytes (e.g. auto data = reinterpret_cast<uchar*>(myStruct)),
+     * but does not allow the other way around; however, in the case of a very simple struct of ints, almost no known compiler
+     * inserts padding between the members, so here we're gonna try what is technically UB, casting an array to a struct, since
+     * it generally works and this application is non-critical. This is possible because each struct member is exactly 1-byte in
+     * size and is laid out in the correct R-G-B-A order.
+     *
+     * This lib has a really strange interface, as it was hacked together by someone else after its initial creation.
+     * You make an image with uncompressed pixel data, despite the type (Etc::Image) being named like you already have
+     * a compressed image, and then call Encode.
+     *
+     * Rows are expected to be contiguous, which they always are for RGBA8 QImages.
+     */
+    Q_ASSERT(pitch == width * 4);
+    Etc::Image etcImage(etcFormat, (const Etc::ColorR8G8B8A8*)rgba, width, height, errMetric);
+
+    auto status = etcImage.EncodeSinglepass(getEtcEffort(quality), blocks);
+    if(status != Etc::Image::SUCCESS)
+        qWarning("Unexpected ETC2 encode error: 0x%x", status);
+}
+
+void Etc2CompCodec::decode(const uchar* blocks, int width, int height, uchar* rgba, int pitch,
+                           KTex::Header::PixelFormat format) const
+{
+    Q_UNUSED(format);
+
+    auto etcFormat = Etc::Image::Format::RGBA8; // Make function for this, like for squish, if more ETC formats are supported
+
+    /* This lib has a really strange interface, as it was hacked together by someone else after its initial creation.
+     * You make an image with no pixel data set and then pass the pixel data as part of the Encode call
+     *
+     * The output is contiguous rows of the source width (the padding of partial blocks is clipped), so it's
+     * decoded to the side and then copied into place.
+     */
+    Etc::Image etcImage(etcFormat, nullptr, width, height, Etc::ErrorMetric::NUMERIC);
+    QByteArray decoded(width * height * 4, Qt::Uninitialized);
+    auto status = etcImage.Decode(blocks, reinterpret_cast<uchar*>(decoded.data()));
+    if(status != Etc::Image::SUCCESS)
+    {
+        qWarning("Unexpected ETC2 decode error: 0x%x", status);
+        return;
+    }
+
+    for(int y = 0; y < height; y++)
+        std::memcpy(rgba + y * pitch, decoded.constData() + y * width * 4, width * 4);
+}
@@ -0,0 +1,23 @@
+#ifndef ETC2COMP_CODEC_H
+#define ETC2COMP_CODEC_H
+
+// Project Includes
+#include "block-codec.h"
+
+class Etc2CompCodec : public BlockCodec
+{
+//-Instance Functions----------------------------------------------------------------------------------------------
+public:
+    QString name() const override;
+    QString libraryVersion() const override;
+    int bandBlockRows() const override;
+
+    bool encodes(KTex::Header::PixelFormat format) const override;
+    bool decodes(KTex::Header::PixelFormat format) const override;
+    void encode(const uchar* rgba, int width, int height, int pitch, uchar* blocks,
+                KTex::Header::PixelFormat format, Quality quality, bool grayscale) const override;
+    void decode(const uchar* blocks, int width, int height, uchar* rgba, int pitch,
+                KTex::Header::PixelFormat format) const override;
+};
+
+#endif // ETC2COMP_CODEC_H
@@ -0,0 +1,260 @@
+// Unit Includes
+#include "etcdec-codec.h"
+
+// Standard Library Includes
+#include <algorithm>
+#include <cstring>
+
+//===============================================================================================================
+// UNIT ONLY
+//===============================================================================================================
+namespace
+{
+    using Pixels = uchar[16][4]; // One 4x4 block of RGBA, row major
+
+    // Intensity modifiers per table codeword, in pixel index order (+small, +large, -small, -large)
+    const int ETC_MODIFIERS[8][4]{
+        {2, 8, -2, -8},
+        {5, 17, -5, -17},
+        {9, 29, -9, -29},
+        {13, 42, -13, -42},
+        {18, 60, -18, -60},
+        {24, 80, -24, -80},
+        {33, 106, -33, -106},
+        {47, 183, -47, -183}
+    };
+
+    // Distances between the paint colors of the T and H modes
+    const int ETC_DISTANCES[8]{3, 6, 11, 16, 23, 32, 41, 64};
+
+    const int EAC_MODIFIERS[16][8]{
+        {-3, -6, -9, -15, 2, 5, 8, 14},
+        {-3, -7, -10, -13, 2, 6, 9, 12},
+        {-2, -5, -8, -13, 1, 4, 7, 12},
+        {-2, -4, -6, -13, 1, 3, 5, 12},
+        {-3, -6, -8, -12, 2, 5, 7, 11},
+        {-3, -7, -9, -11, 2, 6, 8, 10},
+        {-4, -7, -8, -11, 3, 6, 7, 10},
+        {-3, -5, -8, -11, 2, 4, 7, 10},
+        {-2, -6, -8, -10, 1, 5, 7, 9},
+        {-2, -5, -8, -10, 1, 4, 7, 9},
+        {-2, -4, -8, -10, 1, 3, 7, 9},
+        {-2, -5, -7, -10, 1, 4, 6, 9},
+        {-3, -4, -7, -10, 2, 3, 6, 9},
+        {-1, -2, -3, -10, 0, 1, 2, 9},
+        {-4, -6, -8, -9, 3, 5, 7, 8},
+        {-3, -5, -7, -9, 2, 4, 6, 8}
+    };
+
+    uchar clampByte(int value) { return uchar(std::clamp(value, 0, 255)); }
+
+    // Bit replication up to 8 bits
+    int extend4(int value) { return value * 17; }
+    int extend5(int value) { return (value << 3) | (value >> 2); }
+    int extend6(int value) { return (value << 2) | (value >> 4); }
+    int extend7(int value) { return (value << 1) | (value >> 6); }
+
+    // Signed 3-bit delta of the differential mode
+    int delta3(int value) { return (value & 3) - (value & 4); }
+
+    // Blocks are big endian, with pixel indices stored column by column
+    int colorIndex(const uchar* block, int x, int y)
+    {
+        int i = x * 4 + y;
+        int msb = (block[4] << 8 | block[5]) >> i & 1;
+        int lsb = (block[6] << 8 | block[7]) >> i & 1;
+        return msb << 1 | lsb;
+    }
+
+    void decodePaintColors(const uchar* block, const int (&paint)[4][3], Pixels& px)
+    {
+        for(int y = 0; y < 4; y++)
+            for(int x = 0; x < 4; x++)
+                for(int c = 0; c < 3; c++)
+                    px[y * 4 + x][c] = uchar(paint[colorIndex(block, x, y)][c]);
+    }
+
+    void decodeTMode(const uchar* block, Pixels& px)
+    {
+        int base0[3]{extend4((block[0] & 0x18) >> 1 | (block[0] & 0x03)), extend4(block[1] >> 4), extend4(block[1] & 0x0F)};
+        int base1[3]{extend4(block[2] >> 4), extend4(block[2] & 0x0F), extend4(block[3] >> 4)};
+        int distance = ETC_DISTANCES[(block[3] & 0x0C) >> 1 | (block[3] & 0x01)];
+
+        int paint[4][3];
+        for(int c = 0; c < 3; c++)
+        {
+            paint[0][c] = base0[c];
+            paint[1][c] = clampByte(base1[c] + distance);
+            paint[2][c] = base1[c];
+            paint[3][c] = clampByte(base1[c] - distance);
+        }
+        decodePaintColors(block, paint, px);
+    }
+
+    void decodeHMode(const uchar* block, Pixels& px)
+    {
+        int base0[3]{
+            extend4((block[0] & 0x78) >> 3),
+            extend4((block[0] & 0x07) << 1 | (block[1] & 0x10) >> 4),
+            extend4((block[1] & 0x08) | (block[1] & 0x03) << 1 | block[2] >> 7)
+        };
+        int base1[3]{
+            extend4((block[2] & 0x78) >> 3),
+            extend4((block[2] & 0x07) << 1 | block[3] >> 7),
+            extend4((block[3] & 0x78) >> 3)
+        };
+
+        // The last bit of the distance is implied by the order of the base colors
+        int order = (base0[0] << 16 | base0[1] << 8 | base0[2]) >= (base1[0] << 16 | base1[1] << 8 | base1[2]);
+        int distance = ETC_DISTANCES[(block[3] & 0x04) | (block[3] & 0x01) << 1 | order];
+
+        int paint[4][3];
+        for(int c = 0; c < 3; c++)
+        {
+            paint[0][c] = clampByte(base0[c] + distance);
+            paint[1][c] = clampByte(base0[c] - distance);
+            paint[2][c] = clampByte(base1[c] + distance);
+            paint[3][c] = clampByte(base1[c] - distance);
+        }
+        decodePaintColors(block, paint, px);
+    }
+
+    void decodePlanarMode(const uchar* block, Pixels& px)
+    {
+        // Colors at the origin, horizontal and vertical extents, which are interpolated between
+        int o[3]{
+            extend6((block[0] & 0x7E) >> 1),
+            extend7((block[0] & 0x01) << 6 | (block[1] & 0x7E) >> 1),
+            extend6((block[1] & 0x01) << 5 | (block[2] & 0x18) | (block[2] & 0x03) << 1 | block[3] >> 7)
+        };
+        int h[3]{
+            extend6((block[3] & 0x7C) >> 1 | (block[3] & 0x01)),
+            extend7(block[4] >> 1),
+            extend6((block[4] & 0x01) << 5 | block[5] >> 3)
+        };
+        int v[3]{
+            extend6((block[5] & 0x07) << 3 | block[6] >> 5),
+            extend7((block[6] & 0x1F) << 2 | block[7] >> 6),
+            extend6(block[7] & 0x3F)
+        };
+
+        for(int y = 0; y < 4; y++)
+            for(int x = 0; x < 4; x++)
+                for(int c = 0; c < 3; c++)
+                    px[y * 4 + x][c] = clampByte((x * (h[c] - o[c]) + y * (v[c] - o[c]) + 4 * o[c] + 2) >> 2);
+    }
+
+    void decodeColor(const uchar* block, Pixels& px)
+    {
+        int base[2][3];
+        if(!(block[3] & 0x02))
+        {
+            // Individual
+            for(int c = 0; c < 3; c++)
+            {
+                base[0][c] = extend4(block[c] >> 4);
+                base[1][c] = extend4(block[c] & 0x0F);
+            }
+        }
+        else
+        {
+            // Differential, where a second color out of range selects one of the other modes instead
+            int first[3];
+            int second[3];
+            for(int c = 0; c < 3; c++)
+            {
+                first[c] = block[c] >> 3;
+                second[c] = first[c] + delta3(block[c] & 0x07);
+            }
+
+            if(second[0] < 0 || second[0] > 31)
+            {
+                decodeTMode(block, px);
+                return;
+            }
+            if(second[1] < 0 || second[1] > 31)
+            {
+                decodeHMode(block, px);
+                return;
+            }
+            if(second[2] < 0 || second[2] > 31)
+            {
+                decodePlanarMode(block, px);
+                return;
+            }
+
+            for(int c = 0; c < 3; c++)
+            {
+                base[0][c] = extend5(first[c]);
+                base[1][c] = extend5(second[c]);
+            }
+        }
+
+        // Two halves, side by side or stacked when flipped, each with a base color and modifier table
+        int tables[2]{block[3] >> 5, (block[3] >> 2) & 0x07};
+        bool flip = block[3] & 0x01;
+        for(int y = 0; y < 4; y++)
+        {
+            for(int x = 0; x < 4; x++)
+            {
+                int half = flip ? y / 2 : x / 2;
+                int modifier = ETC_MODIFIERS[tables[half]][colorIndex(block, x, y)];
+                for(int c = 0; c < 3; c++)
+                    px[y * 4 + x][c] = clampByte(base[half][c] + modifier);
+            }
+        }
+    }
+
+    void decodeAlpha(const uchar* block, Pixels& px)
+    {
+        int base = block[0];
+        int multiplier = block[1] >> 4;
+        const int (&modifiers)[8] = EAC_MODIFIERS[block[1] & 0x0F];
+
+        // 3-bit indices, column by column from the most significant bits
+        quint64 indices = 0;
+        for(int b = 2; b < 8; b++)
+            indices = indices << 8 | block[b];
+
+        for(int i = 0; i < 16; i++)
+        {
+            int x = i / 4;
+            int y = i % 4;
+            px[y * 4 + x][3] = clampByte(base + modifiers[indices >> (45 - i * 3) & 7] * multiplier);
+        }
+    }
+}
+
+//===============================================================================================================
+// EtcDecCodec
+//===============================================================================================================
+
+//-Instance Functions--------------------------------------------------------------------------------------------
+//Public:
+QString EtcDecCodec::name() const { return u"etcdec"_s; }
+int EtcDecCodec::bandBlockRows() const { return 16; }
+bool EtcDecCodec::decodes(KTex::Header::PixelFormat format) const { return format == KTex::Header::PixelFormat::ETC2EAC; }
+
+void EtcDecCodec::decode(const uchar* blocks, int width, int height, uchar* rgba, int pitch,
+                         KTex::Header::PixelFormat format) const
+{
+    Q_ASSERT(decodes(format));
+    Q_UNUSED(format);
+
+    // Alpha comes first in each block, then color
+    const uchar* block = blocks;
+    for(int y = 0; y < height; y += 4)
+    {
+        for(int x = 0; x < width; x += 4, block += 16)
+        {
+            Pixels px;
+            decodeAlpha(block, px);
+            decodeColor(block + 8, px);
+
+            // Blocks hanging over the edge of the image are clipped
+            int columnBytes = std::min(4, width - x) * 4;
+            for(int row = 0; row < std::min(4, height - y); row++)
+                std::memcpy(rgba + (y + row) * pitch + x * 4, px[row * 4], columnBytes);
+        }
+    }
+}
@@ -0,0 +1,22 @@
+#ifndef ETCDEC_CODEC_H
+#define ETCDEC_CODEC_H
+
+// Project Includes
+#include "block-codec.h"
+
+/* A built-in ETC2 RGBA8 (ETC2 color + EAC alpha) decoder covering every block mode of the format. Unlike the
+ * etc2comp decoder it works on any size of image and any subset of its rows, so it can decode concurrently.
+ */
+class EtcDecCodec : public BlockCodec
+{
+//-Instance Functions----------------------------------------------------------------------------------------------
+public:
+    QString name() const override;
+    int bandBlockRows() const override;
+
+    bool decodes(KTex::Header::PixelFormat format) const override;
+    void decode(const uchar* blocks, int width, int height, uchar* rgba, int pitch,
+                KTex::Header::PixelFormat format) const override;
+};
+
+#endif // ETCDEC_CODEC_H
@@ -0,0 +1,306 @@
+// Unit Includes
+#include "fastdxt-codec.h"
+
+// Standard Library Includes
+#include <algorithm>
+#include <cstring>
+
+// Project Includes
+#include "cpu-features.h"
+
+// SIMD Includes
+#ifdef STEX_X86
+    #include <immintrin.h>
+#endif
+
+//===============================================================================================================
+// UNIT ONLY
+//===============================================================================================================
+namespace
+{
+    // Both kernels reproduce squish's arithmetic exactly, including its truncating divisions
+
+    // Decodes one block into 4 rows of 4 RGBA8 pixels, 'pitch' bytes apart
+    using BlockDecoder = void (*)(const uchar* block, KTex::Header::PixelFormat format, uchar* rgba, int pitch);
+
+    int read565(const uchar* packed) { return packed[0] | packed[1] << 8; }
+
+    void unpack565(int value, uchar* color)
+    {
+        int r = (value >> 11) & 0x1F;
+        int g = (value >> 5) & 0x3F;
+        int b = value & 0x1F;
+
+        color[0] = uchar((r << 3) | (r >> 2));
+        color[1] = uchar((g << 2) | (g >> 4));
+        color[2] = uchar((b << 3) | (b >> 2));
+        color[3] = 255;
+    }
+
+    // Values of the 8 alpha codes of a DXT5 block
+    void dxt5AlphaPalette(int alpha0, int alpha1, uchar (&codes)[8])
+    {
+        codes[0] = uchar(alpha0);
+        codes[1] = uchar(alpha1);
+        if(alpha0 > alpha1)
+        {
+            for(int i = 1; i < 7; i++)
+                codes[1 + i] = uchar(((7 - i) * alpha0 + i * alpha1) / 7);
+        }
+        else
+        {
+            for(int i = 1; i < 5; i++)
+                codes[1 + i] = uchar(((5 - i) * alpha0 + i * alpha1) / 5);
+            codes[6] = 0;
+            codes[7] = 255;
+        }
+    }
+
+    // The 4 three bit alpha indices of a row of a DXT5 block
+    quint32 dxt5AlphaRow(const uchar* block, int row)
+    {
+        // Two rows share each group of 3 bytes
+        const uchar* group = block + 2 + (row / 2) * 3;
+        quint32 bits = (group[0] | group[1] << 8 | group[2] << 16) >> ((row % 2) * 12);
+
+        return (bits & 7) | (bits >> 3 & 7) << 8 | (bits >> 6 & 7) << 16 | (bits >> 9 & 7) << 24;
+    }
+
+    //-Scalar kernel-------------------------------------------------------------------------------------------
+    void decodeBlockScalar(const uchar* block, KTex::Header::PixelFormat format, uchar* rgba, int pitch)
+    {
+        using enum KTex::Header::PixelFormat;
+        const uchar* colorBlock = format == DXT1 ? block : block + 8;
+
+        // Color
+        int a = read565(colorBlock);
+        int b = read565(colorBlock + 2);
+
+        uchar codes[4][4];
+        unpack565(a, codes[0]);
+        unpack565(b, codes[1]);
+        for(int c = 0; c < 4; c++)
+        {
+            int c0 = codes[0][c];
+            int c1 = codes[1][c];
+            if(format == DXT1 && a <= b)
+            {
+                codes[2][c] = uchar((c0 + c1) / 2);
+                codes[3][c] = 0;
+            }
+            else
+            {
+                codes[2][c] = uchar((2 * c0 + c1) / 3);
+                codes[3][c] = uchar((c0 + 2 * c1) / 3);
+            }
+        }
+
+        for(int y = 0; y < 4; y++)
+        {
+            uchar* row = rgba + y * pitch;
+            int indices = colorBlock[4 + y];
+            for(int x = 0; x < 4; x++)
+                std::memcpy(row + x * 4, codes[(indices >> (x * 2)) & 3], 4);
+        }
+
+        // Alpha
+        if(format == DXT3)
+        {
+            for(int y = 0; y < 4; y++)
+            {
+                uchar* row = rgba + y * pitch;
+                for(int x = 0; x < 4; x += 2)
+                {
+                    int quant = block[y * 2 + x / 2];
+                    int low = quant & 0x0F;
+                    int high = quant & 0xF0;
+                    row[x * 4 + 3] = uchar(low | (low << 4));
+                    row[x * 4 + 7] = uchar(high | (high >> 4));
+                }
+            }
+        }
+        else if(format == DXT5)
+        {
+            uchar alphaCodes[8];
+            dxt5AlphaPalette(block[0], block[1], alphaCodes);
+
+            for(int y = 0; y < 4; y++)
+            {
+                uchar* row = rgba + y * pitch;
+                quint32 indices = dxt5AlphaRow(block, y);
+                for(int x = 0; x < 4; x++)
+                    row[x * 4 + 3] = alphaCodes[(indices >> (x * 8)) & 0xFF];
+            }
+        }
+    }
+
+#ifdef STEX_X86
+    //-SSSE3 kernel--------------------------------------------------------------------------------------------
+    STEX_TARGET_SSSE3 void decodeBlockSsse3(const uchar* block, KTex::Header::PixelFormat format, uchar* rgba, int pitch)
+    {
+        using enum KTex::Header::PixelFormat;
+        const uchar* colorBlock = format == DXT1 ? block : block + 8;
+
+        // Color palette, interpolated in 16-bit lanes as [c0 c1 | c1 c0] so each half produces one code
+        int a = read565(colorBlock);
+        int b = read565(colorBlock + 2);
+
+        uchar ends[2][4];
+        unpack565(a, ends[0]);
+        unpack565(b, ends[1]);
+        __m128i endpoints = _mm_setr_epi16(ends[0][0], ends[0][1], ends[0][2], ends[0][3],
+                                           ends[1][0], ends[1][1], ends[1][2], ends[1][3]);
+        __m128i swapped = _mm_shuffle_epi32(endpoints, _MM_SHUFFLE(1, 0, 3, 2));
+
+        __m128i mixed;
+        if(format == DXT1 && a <= b)
+        {
+            // Midpoint and transparent black
+            mixed = _mm_move_epi64(_mm_srli_epi16(_mm_add_epi16(endpoints, swapped), 1));
+        }
+        else
+        {
+            // Thirds; x / 3 == ((x * 0xAAAB) >> 16) >> 1 for every sum that can occur here
+            __m128i sum = _mm_add_epi16(_mm_add_epi16(endpoints, endpoints), swapped);
+            mixed = _mm_srli_epi16(_mm_mulhi_epu16(sum, _mm_set1_epi16(short(0xAAAB))), 1);
+        }
+        const __m128i palette = _mm_packus_epi16(endpoints, mixed);
+
+        // Alpha, as 16 bytes in pixel order (DXT3) or as an 8 entry palette (DXT5)
+        __m128i alpha = _mm_setzero_si128();
+        if(format == DXT3)
+        {
+            const __m128i lowNibbles = _mm_set1_epi8(0x0F);
+            __m128i quant = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(block));
+            __m128i low = _mm_and_si128(quant, lowNibbles);
+            __m128i high = _mm_andnot_si128(lowNibbles, quant);
+
+            // The shifts never carry across bytes since the other nibble was masked off
+            low = _mm_or_si128(low, _mm_slli_epi16(low, 4));
+            high = _mm_or_si128(high, _mm_srli_epi16(high, 4));
+            alpha = _mm_unpacklo_epi8(low, high);
+        }
+        else if(format == DXT5)
+        {
+            int alpha0 = block[0];
+            int alpha1 = block[1];
+            __m128i weighted;
+            if(alpha0 > alpha1)
+            {
+                // x / 7 == (x * 9363) >> 16 for every sum that can occur here
+                __m128i sum = _mm_add_epi16(_mm_mullo_epi16(_mm_set1_epi16(short(alpha0)), _mm_setr_epi16(7, 0, 6, 5, 4, 3, 2, 1)),
+                                            _mm_mullo_epi16(_mm_set1_epi16(short(alpha1)), _mm_setr_epi16(0, 7, 1, 2, 3, 4, 5, 6)));
+                weighted = _mm_mulhi_epu16(sum, _mm_set1_epi16(9363));
+            }
+            else
+            {
+                // x / 5 == (x * 13108) >> 16 for every sum that can occur here
+                __m128i sum = _mm_add_epi16(_mm_mullo_epi16(_mm_set1_epi16(short(alpha0)), _mm_setr_epi16(5, 0, 4, 3, 2, 1, 0, 0)),
+                                            _mm_mullo_epi16(_mm_set1_epi16(short(alpha1)), _mm_setr_epi16(0, 5, 1, 2, 3, 4, 0, 0)));
+                weighted = _mm_mulhi_epu16(sum, _mm_set1_epi16(13108));
+                weighted = _mm_insert_epi16(weighted, 255, 7);
+            }
+            alpha = _mm_packus_epi16(weighted, weighted);
+        }
+
+        // Each index selects the 4 bytes of its code, so spread it to all of them and add the byte offsets
+        const __m128i spread = _mm_setr_epi8(0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3);
+        const __m128i offsets = _mm_setr_epi8(0, 1, 2, 3, 0, 1, 2, 3, 0, 1, 2, 3, 0, 1, 2, 3);
+        const __m128i colorMask = _mm_set1_epi32(0x00FFFFFF);
+
+        for(int y = 0; y < 4; y++)
+        {
+            int bits = colorBlock[4 + y];
+            quint32 indices = (bits & 3) | (bits >> 2 & 3) << 8 | (bits >> 4 & 3) << 16 | (bits >> 6 & 3) << 24;
+
+            __m128i select = _mm_shuffle_epi8(_mm_cvtsi32_si128(int(indices)), spread);
+            select = _mm_add_epi8(select, select);
+            select = _mm_add_epi8(_mm_add_epi8(select, select), offsets);
+            __m128i pixels = _mm_shuffle_epi8(palette, select);
+
+            if(format == DXT3)
+            {
+                // Move this row's 4 alpha values into the alpha bytes, zeroing the rest
+                __m128i place = _mm_setr_epi8(-1, -1, -1, 0, -1, -1, -1, 1, -1, -1, -1, 2, -1, -1, -1, 3);
+                place = _mm_add_epi8(place, _mm_set1_epi32((y * 4) << 24));
+                pixels = _mm_or_si128(_mm_and_si128(pixels, colorMask), _mm_shuffle_epi8(alpha, place));
+            }
+            else if(format == DXT5)
+            {
+                // Look up the alpha indices in the alpha bytes only, the set high bits elsewhere zero the rest
+                __m128i place = _mm_shuffle_epi8(_mm_cvtsi32_si128(int(dxt5AlphaRow(block, y))), spread);
+                place = _mm_or_si128(place, colorMask);
+                pixels = _mm_or_si128(_mm_and_si128(pixels, colorMask), _mm_shuffle_epi8(alpha, place));
+            }
+
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(rgba + y * pitch), pixels);
+        }
+    }
+#endif
+
+    struct Kernel
+    {
+        const char* name;
+        BlockDecoder decodeBlock;
+    };
+
+    Kernel selectKernel()
+    {
+#ifdef STEX_X86
+        if(CpuFeatures::hasSsse3())
+            return {"ssse3", decodeBlockSsse3};
+#endif
+        return {"scalar", decodeBlockScalar};
+    }
+
+    const Kernel& activeKernel()
+    {
+        static const Kernel selected = selectKernel();
+        return selected;
+    }
+}
+
+//===============================================================================================================
+// FastDxtCodec
+//===============================================================================================================
+
+//-Instance Functions--------------------------------------------------------------------------------------------
+//Public:
+QString FastDxtCodec::name() const { return u"fastdxt"_s; }
+QString FastDxtCodec::kernel() const { return QString::fromLatin1(activeKernel().name); }
+int FastDxtCodec::bandBlockRows() const { return 16; }
+
+bool FastDxtCodec::decodes(KTex::Header::PixelFormat format) const
+{
+    using enum KTex::Header::PixelFormat;
+    return format == DXT1 || format == DXT3 || format == DXT5;
+}
+
+void FastDxtCodec::decode(const uchar* blocks, int width, int height, uchar* rgba, int pitch,
+                          KTex::Header::PixelFormat format) const
+{
+    Q_ASSERT(decodes(format));
+
+    const BlockDecoder decodeBlock = activeKernel().decodeBlock;
+    int blockSize = format == KTex::Header::PixelFormat::DXT1 ? 8 : 16;
+    const uchar* block = blocks;
+
+    for(int y = 0; y < height; y += 4)
+    {
+        for(int x = 0; x < width; x += 4, block += blockSize)
+        {
+            if(x + 4 <= width && y + 4 <= height)
+                decodeBlock(block, format, rgba + y * pitch + x * 4, pitch);
+            else
+            {
+                // Blocks hanging over the edge of the image go through a scratch block and are clipped
+                uchar scratch[4 * 16];
+                decodeBlock(block, format, scratch, 16);
+
+                int columnBytes = std::min(4, width - x) * 4;
+                for(int row = 0; row < std::min(4, height - y); row++)
+                    std::memcpy(rgba + (y + row) * pitch + x * 4, scratch + row * 16, columnBytes);
+            }
+        }
+    }
+}
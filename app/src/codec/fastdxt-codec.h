@@ -0,0 +1,23 @@
+#ifndef FASTDXT_CODEC_H
+#define FASTDXT_CODEC_H
+
+// Project Includes
+#include "block-codec.h"
+
+/* A DXT decoder whose output is identical to that of squish, but that interpolates each block's palette and
+ * looks up all of a row's pixels at once with SIMD shuffles instead of working a byte at a time.
+ */
+class FastDxtCodec : public BlockCodec
+{
+//-Instance Functions----------------------------------------------------------------------------------------------
+public:
+    QString name() const override;
+    QString kernel() const override;
+    int bandBlockRows() const override;
+
+    bool decodes(KTex::Header::PixelFormat format) const override;
+    void decode(const uchar* blocks, int width, int height, uchar* rgba, int pitch,
+                KTex::Header::PixelFormat format) const override;
+};
+
+#endif // FASTDXT_CODEC_H
@@ -0,0 +1,408 @@
+// Unit Includes
+#include "rangefit-codec.h"
+
+// Standard Library Includes
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <utility>
+
+// Project Includes
+#include "cpu-features.h"
+
+// SIMD Includes
+#ifdef STEX_X86
+    #include <immintrin.h>
+#endif
+
+//===============================================================================================================
+// UNIT ONLY
+//===============================================================================================================
+namespace
+{
+    using Pixels = uchar[16][4]; // One 4x4 block of RGBA
+
+    void gatherBlock(const uchar* rgba, int width, int height, int pitch, int bx, int by, Pixels& px)
+    {
+        // Pixels past the edge of the image repeat the last row/column, which doesn't skew the range
+        for(int y = 0; y < 4; y++)
+        {
+            const uchar* row = rgba + std::min(by * 4 + y, height - 1) * pitch;
+            for(int x = 0; x < 4; x++)
+                std::memcpy(px[y * 4 + x], row + std::min(bx * 4 + x, width - 1) * 4, 4);
+        }
+    }
+
+    //-Scalar kernel-------------------------------------------------------------------------------------------
+    void channelRangeScalar(const Pixels& px, uchar (&low)[4], uchar (&high)[4])
+    {
+        std::memcpy(low, px[0], 4);
+        std::memcpy(high, px[0], 4);
+        for(int i = 1; i < 16; i++)
+        {
+            for(int c = 0; c < 4; c++)
+            {
+                low[c] = std::min(low[c], px[i][c]);
+                high[c] = std::max(high[c], px[i][c]);
+            }
+        }
+    }
+
+    // Projects each pixel onto the line from 'from' towards 'dir', giving (pixel - from) . dir
+    void projectScalar(const Pixels& px, const int (&from)[3], const int (&dir)[3], int (&dots)[16])
+    {
+        for(int i = 0; i < 16; i++)
+            dots[i] = (px[i][0] - from[0]) * dir[0] + (px[i][1] - from[1]) * dir[1] + (px[i][2] - from[2]) * dir[2];
+    }
+
+#ifdef STEX_SSE2
+    //-SSE2 kernel---------------------------------------------------------------------------------------------
+    void channelRangeSse2(const Pixels& px, uchar (&low)[4], uchar (&high)[4])
+    {
+        __m128i p0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(px[0]));
+        __m128i p1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(px[4]));
+        __m128i p2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(px[8]));
+        __m128i p3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(px[12]));
+
+        // Reduce the four pixels of each lane down to one
+        __m128i min = _mm_min_epu8(_mm_min_epu8(p0, p1), _mm_min_epu8(p2, p3));
+        __m128i max = _mm_max_epu8(_mm_max_epu8(p0, p1), _mm_max_epu8(p2, p3));
+        min = _mm_min_epu8(min, _mm_srli_si128(min, 8));
+        max = _mm_max_epu8(max, _mm_srli_si128(max, 8));
+        min = _mm_min_epu8(min, _mm_srli_si128(min, 4));
+        max = _mm_max_epu8(max, _mm_srli_si128(max, 4));
+
+        int lowPx = _mm_cvtsi128_si32(min);
+        int highPx = _mm_cvtsi128_si32(max);
+        std::memcpy(low, &lowPx, 4);
+        std::memcpy(high, &highPx, 4);
+    }
+
+    void projectSse2(const Pixels& px, const int (&from)[3], const int (&dir)[3], int (&dots)[16])
+    {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i base = _mm_setr_epi16(from[0], from[1], from[2], 0, from[0], from[1], from[2], 0);
+        const __m128i axis = _mm_setr_epi16(dir[0], dir[1], dir[2], 0, dir[0], dir[1], dir[2], 0); // Alpha is ignored
+
+        for(int i = 0; i < 16; i += 4)
+        {
+            __m128i p = _mm_loadu_si128(reinterpret_cast<const __m128i*>(px[i]));
+
+            // Widen to 16-bit so the offsets can go negative, then r*dr + g*dg and b*db per pixel pair
+            __m128i lo = _mm_madd_epi16(_mm_sub_epi16(_mm_unpacklo_epi8(p, zero), base), axis);
+            __m128i hi = _mm_madd_epi16(_mm_sub_epi16(_mm_unpackhi_epi8(p, zero), base), axis);
+
+            // Sum the pairs
+            __m128 even = _mm_shuffle_ps(_mm_castsi128_ps(lo), _mm_castsi128_ps(hi), _MM_SHUFFLE(2, 0, 2, 0));
+            __m128 odd = _mm_shuffle_ps(_mm_castsi128_ps(lo), _mm_castsi128_ps(hi), _MM_SHUFFLE(3, 1, 3, 1));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dots + i), _mm_add_epi32(_mm_castps_si128(even), _mm_castps_si128(odd)));
+        }
+    }
+#endif
+
+#ifdef STEX_X86
+    //-AVX2 kernel---------------------------------------------------------------------------------------------
+    STEX_TARGET_AVX2 void channelRangeAvx2(const Pixels& px, uchar (&low)[4], uchar (&high)[4])
+    {
+        __m256i p0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(px[0]));
+        __m256i p1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(px[8]));
+
+        // Halve down to 8 pixels per lane, then fold lanes and pixels together
+        __m256i min256 = _mm256_min_epu8(p0, p1);
+        __m256i max256 = _mm256_max_epu8(p0, p1);
+        __m128i min = _mm_min_epu8(_mm256_castsi256_si128(min256), _mm256_extracti128_si256(min256, 1));
+        __m128i max = _mm_max_epu8(_mm256_castsi256_si128(max256), _mm256_extracti128_si256(max256, 1));
+        min = _mm_min_epu8(min, _mm_srli_si128(min, 8));
+        max = _mm_max_epu8(max, _mm_srli_si128(max, 8));
+        min = _mm_min_epu8(min, _mm_srli_si128(min, 4));
+        max = _mm_max_epu8(max, _mm_srli_si128(max, 4));
+
+        int lowPx = _mm_cvtsi128_si32(min);
+        int highPx = _mm_cvtsi128_si32(max);
+        std::memcpy(low, &lowPx, 4);
+        std::memcpy(high, &highPx, 4);
+    }
+
+    STEX_TARGET_AVX2 void projectAvx2(const Pixels& px, const int (&from)[3], const int (&dir)[3], int (&dots)[16])
+    {
+        const __m256i base = _mm256_setr_epi16(from[0], from[1], from[2], 0, from[0], from[1], from[2], 0,
+                                               from[0], from[1], from[2], 0, from[0], from[1], from[2], 0);
+        const __m256i axis = _mm256_setr_epi16(dir[0], dir[1], dir[2], 0, dir[0], dir[1], dir[2], 0,
+                                               dir[0], dir[1], dir[2], 0, dir[0], dir[1], dir[2], 0); // Alpha is ignored
+
+        for(int i = 0; i < 16; i += 8)
+        {
+            // Four pixels widened to 16-bit per register, giving two partial sums per pixel
+            __m256i a = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(px[i])));
+            __m256i b = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(px[i + 4])));
+            a = _mm256_madd_epi16(_mm256_sub_epi16(a, base), axis);
+            b = _mm256_madd_epi16(_mm256_sub_epi16(b, base), axis);
+
+            // Sums come out per lane as [0 1 4 5 | 2 3 6 7], so put them back in order
+            __m256i sums = _mm256_permute4x64_epi64(_mm256_hadd_epi32(a, b), _MM_SHUFFLE(3, 1, 2, 0));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dots + i), sums);
+        }
+    }
+#endif
+
+    struct Kernel
+    {
+        const char* name;
+        void (*channelRange)(const Pixels& px, uchar (&low)[4], uchar (&high)[4]);
+        void (*project)(const Pixels& px, const int (&from)[3], const int (&dir)[3], int (&dots)[16]);
+    };
+
+    Kernel selectKernel()
+    {
+#ifdef STEX_X86
+        if(CpuFeatures::hasAvx2())
+            return {"avx2", channelRangeAvx2, projectAvx2};
+#endif
+#ifdef STEX_SSE2
+        return {"sse2", channelRangeSse2, projectSse2};
+#else
+        return {"scalar", channelRangeScalar, projectScalar};
+#endif
+    }
+
+    const Kernel& activeKernel()
+    {
+        static const Kernel selected = selectKernel();
+        return selected;
+    }
+
+    // Nearest of 'steps' + 1 evenly spaced points along the projection, 0 being the start
+    int quantize(int dot, int length2, int steps)
+    {
+        if(dot <= 0)
+            return 0;
+        return std::min(steps, (dot * steps * 2 + length2) / (length2 * 2));
+    }
+
+    quint16 pack565(const int (&rgb)[3])
+    {
+        return quint16(((rgb[0] * 31 + 127) / 255) << 11 | ((rgb[1] * 63 + 127) / 255) << 5 | ((rgb[2] * 31 + 127) / 255));
+    }
+
+    void unpack565(quint16 color, int (&rgb)[3])
+    {
+        int r = color >> 11 & 0x1F;
+        int g = color >> 5 & 0x3F;
+        int b = color & 0x1F;
+        rgb[0] = r << 3 | r >> 2;
+        rgb[1] = g << 2 | g >> 4;
+        rgb[2] = b << 3 | b >> 2;
+    }
+
+    void writeLe16(uchar* out, quint16 value)
+    {
+        out[0] = uchar(value);
+        out[1] = uchar(value >> 8);
+    }
+
+    void writeLe32(uchar* out, quint32 value)
+    {
+        writeLe16(out, quint16(value));
+        writeLe16(out + 2, quint16(value >> 16));
+    }
+
+    void compressColor(Pixels& px, bool dxt1, uchar* block)
+    {
+        // DXT1 marks pixels with less than half alpha as transparent, which requires the 3 color mode
+        bool transparent[16]{};
+        int opaque = -1;
+        for(int i = 0; i < 16; i++)
+        {
+            transparent[i] = dxt1 && px[i][3] < 128;
+            if(!transparent[i] && opaque == -1)
+                opaque = i;
+        }
+        bool threeColor = std::any_of(std::begin(transparent), std::end(transparent), [](bool t){ return t; });
+
+        if(opaque == -1)
+        {
+            writeLe16(block, 0);
+            writeLe16(block + 2, 0);
+            writeLe32(block + 4, 0xFFFFFFFF);
+            return;
+        }
+
+        // Transparent pixels take the place of an opaque one so they don't widen the range
+        for(int i = 0; i < 16; i++)
+            if(transparent[i])
+                std::memcpy(px[i], px[opaque], 4);
+
+        uchar low[4], high[4];
+        activeKernel().channelRange(px, low, high);
+
+        // The bounding box diagonal only follows the colors when they rise together, so check each channel against green (or red)
+        int center[3] = {(low[0] + high[0]) / 2, (low[1] + high[1]) / 2, (low[2] + high[2]) / 2};
+        int covRG = 0, covBG = 0, covBR = 0;
+        for(int i = 0; i < 16; i++)
+        {
+            int r = px[i][0] - center[0];
+            int g = px[i][1] - center[1];
+            int b = px[i][2] - center[2];
+            covRG += r * g;
+            covBG += b * g;
+            covBR += b * r;
+        }
+
+        int start[3] = {low[0], low[1], low[2]};
+        int end[3] = {high[0], high[1], high[2]};
+        if(low[1] != high[1])
+        {
+            if(covRG < 0)
+                std::swap(start[0], end[0]);
+            if(covBG < 0)
+                std::swap(start[2], end[2]);
+        }
+        else if(covBR < 0)
+            std::swap(start[2], end[2]);
+
+        // Pull the endpoints in slightly, since the extremes are rarely worth a whole palette entry
+        for(int c = 0; c < 3; c++)
+        {
+            int inset = (end[c] - start[c]) / 16;
+            start[c] += inset;
+            end[c] -= inset;
+        }
+
+        quint16 c0 = pack565(end);
+        quint16 c1 = pack565(start);
+
+        // The order of the endpoints selects the mode, 4 colors if c0 > c1, otherwise 3 colors and transparent
+        if(threeColor ? c0 > c1 : c0 < c1)
+            std::swap(c0, c1);
+
+        quint32 indices = 0;
+        if(c0 != c1)
+        {
+            int e0[3], e1[3];
+            unpack565(c0, e0);
+            unpack565(c1, e1);
+
+            // Palette positions along the line between endpoints, mapped to their indices
+            static const int FOUR_COLOR_INDEX[4] = {1, 3, 2, 0}; // From c1 to c0
+            static const int THREE_COLOR_INDEX[3] = {0, 2, 1}; // From c0 to c1
+            const int* indexMap = threeColor ? THREE_COLOR_INDEX : FOUR_COLOR_INDEX;
+            int steps = threeColor ? 2 : 3;
+            const int (&from)[3] = threeColor ? e0 : e1;
+            const int (&to)[3] = threeColor ? e1 : e0;
+
+            int dir[3] = {to[0] - from[0], to[1] - from[1], to[2] - from[2]};
+            int length2 = dir[0] * dir[0] + dir[1] * dir[1] + dir[2] * dir[2];
+
+            int dots[16];
+            activeKernel().project(px, from, dir, dots);
+            for(int i = 0; i < 16; i++)
+            {
+                int index = transparent[i] ? 3 : indexMap[quantize(dots[i], length2, steps)];
+                indices |= quint32(index) << (i * 2);
+            }
+        }
+        else if(threeColor)
+        {
+            for(int i = 0; i < 16; i++)
+                if(transparent[i])
+                    indices |= quint32(3) << (i * 2);
+        }
+
+        writeLe16(block, c0);
+        writeLe16(block + 2, c1);
+        writeLe32(block + 4, indices);
+    }
+
+    void compressExplicitAlpha(const Pixels& px, uchar* block)
+    {
+        for(int i = 0; i < 16; i += 2)
+        {
+            int a0 = (px[i][3] * 15 + 127) / 255;
+            int a1 = (px[i + 1][3] * 15 + 127) / 255;
+            block[i / 2] = uchar(a0 | a1 << 4);
+        }
+    }
+
+    void compressInterpolatedAlpha(const Pixels& px, uchar low, uchar high, uchar* block)
+    {
+        // Always the 8 alpha mode (a0 > a1), keeping the extremes exact
+        block[0] = high;
+        block[1] = low;
+
+        quint64 indices = 0;
+        if(high != low)
+        {
+            int range = high - low;
+            for(int i = 0; i < 16; i++)
+            {
+                int step = quantize(px[i][3] - low, range, 7);
+                int index = step == 7 ? 0 : step == 0 ? 1 : 8 - step;
+                indices |= quint64(index) << (i * 3);
+            }
+        }
+
+        for(int b = 0; b < 6; b++)
+            block[2 + b] = uchar(indices >> (b * 8));
+    }
+}
+
+//===============================================================================================================
+// RangeFitCodec
+//===============================================================================================================
+
+//-Instance Functions--------------------------------------------------------------------------------------------
+//Public:
+QString RangeFitCodec::name() const { return u"rangefit"_s; }
+QString RangeFitCodec::kernel() const { return QString::fromLatin1(activeKernel().name); }
+int RangeFitCodec::bandBlockRows() const { return 16; }
+
+bool RangeFitCodec::encodes(KTex::Header::PixelFormat format) const
+{
+    using enum KTex::Header::PixelFormat;
+    return format == DXT1 || format == DXT3 || format == DXT5;
+}
+
+void RangeFitCodec::encode(const uchar* rgba, int width, int height, int pitch, uchar* blocks,
+                           KTex::Header::PixelFormat format, Quality quality, bool grayscale) const
+{
+    using enum KTex::Header::PixelFormat;
+    Q_ASSERT(encodes(format));
+    Q_UNUSED(quality); // There is nothing to search, so effort doesn't apply
+    Q_UNUSED(grayscale);
+
+    int blockSize = format == DXT1 ? 8 : 16;
+    uchar* block = blocks;
+
+    for(int by = 0; by < (height + 3) / 4; by++)
+    {
+        for(int bx = 0; bx < (width + 3) / 4; bx++, block += blockSize)
+        {
+            Pixels px;
+            gatherBlock(rgba, width, height, pitch, bx, by, px);
+
+            switch(format)
+            {
+                case DXT1:
+                    compressColor(px, true, block);
+                    break;
+
+                case DXT3:
+                    compressExplicitAlpha(px, block);
+                    compressColor(px, false, block + 8);
+                    break;
+
+                case DXT5:
+                {
+                    uchar low[4], high[4];
+                    activeKernel().channelRange(px, low, high);
+                    compressInterpolatedAlpha(px, low[3], high[3], block);
+                    compressColor(px, false, block + 8);
+                    break;
+                }
+
+                default:
+                    return;
+            }
+        }
+    }
+}
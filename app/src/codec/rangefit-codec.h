@@ -0,0 +1,25 @@
+#ifndef RANGEFIT_CODEC_H
+#define RANGEFIT_CODEC_H
+
+// Project Includes
+#include "block-codec.h"
+
+/* A DXT encoder in the style of stb_dxt. Instead of searching for the best fitting endpoints like squish,
+ * the endpoints of each block are taken straight from the range its colors cover, trading a little accuracy
+ * for speed; meant for development and preview builds. The color range and index projection have SIMD
+ * kernels, while the rest of the fit and the block packing are scalar.
+ */
+class RangeFitCodec : public BlockCodec
+{
+//-Instance Functions----------------------------------------------------------------------------------------------
+public:
+    QString name() const override;
+    QString kernel() const override;
+    int bandBlockRows() const override;
+
+    bool encodes(KTex::Header::PixelFormat format) const override;
+    void encode(const uchar* rgba, int width, int height, int pitch, uchar* blocks,
+                KTex::Header::PixelFormat format, Quality quality, bool grayscale) const override;
+};
+
+#endif // RANGEFIT_CODEC_H
@@ -0,0 +1,79 @@
+// Unit Includes
+#include "squish-codec.h"
+
+// Squish Includes
+#include <squish/squish.h>
+
+// Project Includes
+#include "project_vars.h"
+
+//===============================================================================================================
+// UNIT ONLY
+//===============================================================================================================
+namespace
+{
+    int getSquishCompressionFlag(KTex::Header::PixelFormat pixelFormat)
+    {
+        switch(pixelFormat)
+        {
+            case KTex::Header::PixelFormat::DXT5:
+                return squish::kDxt5;
+
+            case KTex::Header::PixelFormat::DXT3:
+                return squish::kDxt3;
+
+            case KTex::Header::PixelFormat::DXT1:
+                return squish::kDxt1;
+
+            default:
+                return -1; // Should never occur
+        }
+    }
+
+    int getSquishFitFlag(BlockCodec::Quality quality)
+    {
+        // Cluster fit is squish's own default
+        switch(quality)
+        {
+            case BlockCodec::Quality::Fast:
+                return squish::kColourRangeFit;
+
+            case BlockCodec::Quality::Best:
+                return squish::kColourIterativeClusterFit;
+
+            default:
+                return squish::kColourClusterFit;
+        }
+    }
+}
+
+//===============================================================================================================
+// SquishCodec
+//===============================================================================================================
+
+//-Instance Functions--------------------------------------------------------------------------------------------
+//Public:
+QString SquishCodec::name() const { return u"squish"_s; }
+QString SquishCodec::libraryVersion() const { return QString::fromLatin1(PROJECT_LIBSQUISH_VERSION_STR); }
+int SquishCodec::bandBlockRows() const { return 16; }
+
+bool SquishCodec::encodes(KTex::Header::PixelFormat format) const
+{
+    using enum KTex::Header::PixelFormat;
+    return format == DXT1 || format == DXT3 || format == DXT5;
+}
+
+bool SquishCodec::decodes(KTex::Header::PixelFormat format) const { return encodes(format); }
+
+void SquishCodec::encode(const uchar* rgba, int width, int height, int pitch, uchar* blocks,
+                         KTex::Header::PixelFormat format, Quality quality, bool grayscale) const
+{
+    Q_UNUSED(grayscale);
+    squish::CompressImage(rgba, width, height, pitch, blocks, getSquishCompressionFlag(format) | getSquishFitFlag(quality));
+}
+
+void SquishCodec::decode(const uchar* blocks, int width, int height, uchar* rgba, int pitch,
+                         KTex::Header::PixelFormat format) const
+{
+    squish::DecompressImage(rgba, width, height, pitch, blocks, getSquishCompressionFlag(format));
+}
@@ -49,9 +49,9 @@ Qx::Error CCompress::perform()
 {
     mCore.printMessage(NAME, MSG_INPUT_VALIDATION);
 
-    // Get and validate format
-    KTex::Header::PixelFormat outputPixelFormat;
-    if(auto err = getFormat(outputPixelFormat); err.isValid())
+    // Get and validate encoding options
+    ToTexConverter::Options encodeOptions;
+    if(auto err = getEncodeOptions(encodeOptions); err.isValid())
         return err;
 
     // Get input
@@ -79,12 +79,9 @@ Qx::Error CCompress::perform()
     if(auto err = readImage(image, input.absoluteFilePath()); err.isValid())
         return err;
 
-    // Create TEX
-    KTex tex = createTex(image, outputPixelFormat);
-
-    // Write TEX file
+    // Create and write TEX file
     QString absOutputPath = output.absoluteFilePath();
-    if(auto res = writeTex(tex, outputPath); res.isFailure())
+    if(auto res = writeTex(image, encodeOptions, outputPath); res.isFailure())
     {
         CCompressError err(CCompressError::CantWriteTex, absOutputPath, res.outcomeInfo());
         mCore.printError(NAME, err);
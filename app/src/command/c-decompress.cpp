@@ -8,6 +8,7 @@
 
 // Project Includes
 #include "klei/k-tex.h"
+#include "klei/k-tex-io.h"
 
 //===============================================================================================================
 // CDecompressError
@@ -48,20 +49,76 @@ QList<const QCommandLineOption*> CDecompress::options() const { return CL_OPTION
 QSet<const QCommandLineOption*> CDecompress::requiredOptions() const { return CL_OPTIONS_REQUIRED; }
 QString CDecompress::name() const { return NAME; }
 
-//Public:
-Qx::Error CDecompress::perform()
+//Private:
+CDecompressError CDecompress::getMipMapSelection(int& first, int& count) const
 {
-    mCore.printMessage(NAME, MSG_INPUT_VALIDATION);
+    first = 0;
+    count = 1;
 
-    // Get input
-    QFileInfo input(mParser.value(CL_OPTION_INPUT));
-    if(!input.exists())
+    if(mParser.isSet(CL_OPTION_ALL_MIPS))
     {
-        CDecompressError err(CDecompressError::InvalidInput);
+        count = -1;
+        return CDecompressError();
+    }
+
+    if(!mParser.isSet(CL_OPTION_MIP))
+        return CDecompressError();
+
+    bool validLevel;
+    first = mParser.value(CL_OPTION_MIP).toInt(&validLevel);
+    if(!validLevel || first < 0)
+    {
+        CDecompressError err(CDecompressError::InvalidMipMap);
         mCore.printError(NAME, err);
         return err;
     }
 
+    return CDecompressError();
+}
+
+Qx::Error CDecompress::writeImages(const KTex& tex, const QString& texPath, const QString& outputPath)
+{
+    if(!mParser.isSet(CL_OPTION_ALL_MIPS))
+    {
+        // Only the selected level was read, so it will be missing if the TEX has fewer
+        if(mParser.isSet(CL_OPTION_MIP) && !tex.hasMipMaps())
+        {
+            CDecompressError err(CDecompressError::MissingMipMap, texPath);
+            mCore.printError(NAME, err);
+            return err;
+        }
+
+        // Extract image from TEX
+        QImage image;
+        if(auto err = extractImage(image, tex); err.isValid())
+            return err;
+
+        // Write
+        if(auto err = writeImage(image, outputPath); err.isValid())
+            return err;
+
+        return Qx::Error();
+    }
+
+    // Extract all images from TEX
+    QList<QImage> images;
+    if(auto err = extractImages(images, tex); err.isValid())
+        return err;
+
+    // Write, each beside the others
+    QFileInfo output(outputPath);
+    for(qsizetype i = 0; i < images.size(); i++)
+    {
+        QString levelPath = output.dir().absoluteFilePath(MIP_MAP_OUTPUT_NAME.arg(output.completeBaseName(), QString::number(i), STD_OUTPUT_EXT));
+        if(auto err = writeImage(images.at(i), levelPath); err.isValid())
+            return err;
+    }
+
+    return Qx::Error();
+}
+
+Qx::Error CDecompress::decompressSingle(const QFileInfo& input, int firstMipMap, int mipMapCount)
+{
     // Get output
     QString outputEnd = '.' + STD_OUTPUT_EXT;
     QString outputPath(
@@ -76,23 +133,108 @@ Qx::Error CDecompress::perform()
     // Read TEX
     KTex tex;
     QString texPath = input.absoluteFilePath();
-    if(auto res = readTex(tex, texPath); res.isFailure())
+    if(auto res = readTex(tex, texPath, firstMipMap, mipMapCount); res.isFailure())
     {
         CDecompressError err(CDecompressError::CantReadTex, texPath, res.outcomeInfo());
         mCore.printError(NAME, err);
         return err;
     }
 
-    // Extract main image from TEX
-    QImage image;
-    if(auto err = extractImage(image, tex); err.isValid())
+    // Extract and write
+    if(auto err = writeImages(tex, texPath, output.absoluteFilePath()); err.isValid())
         return err;
 
-    // Write
-    if(auto err = writeImage(image, output.absoluteFilePath()); err.isValid())
+    // Return success
+    mCore.printMessage(NAME, MSG_SUCCESS);
+    return Qx::Error();
+}
+
+Qx::Error CDecompress::decompressBatch(const QFileInfo& input, int firstMipMap, int mipMapCount)
+{
+    // Get prefetch depth
+    int prefetchDepth = KTexPrefetcher::DEFAULT_DEPTH;
+    if(mParser.isSet(CL_OPTION_PREFETCH))
+    {
+        bool validDepth;
+        prefetchDepth = mParser.value(CL_OPTION_PREFETCH).toInt(&validDepth);
+        if(!validDepth || prefetchDepth < 1)
+        {
+            CDecompressError err(CDecompressError::InvalidPrefetch);
+            mCore.printError(NAME, err);
+            return err;
+        }
+    }
+
+    // Get output
+    QDir outputDir(mParser.isSet(CL_OPTION_OUTPUT) ? mParser.value(CL_OPTION_OUTPUT) : input.absoluteFilePath());
+    if(!outputDir.exists() && !outputDir.mkpath(u"."_s))
+    {
+        CDecompressError err(CDecompressError::InvalidOutput);
+        mCore.printError(NAME, err);
         return err;
+    }
+
+    // Get TEX files
+    QFileInfoList texFiles = QDir(input.absoluteFilePath()).entryInfoList({TEX_FILTER}, QDir::Files, QDir::Name);
+    if(texFiles.isEmpty())
+    {
+        CDecompressError err(CDecompressError::NoTex);
+        mCore.printError(NAME, err);
+        return err;
+    }
+
+    QStringList texPaths;
+    for(const QFileInfo& texFile : std::as_const(texFiles))
+        texPaths.append(texFile.absoluteFilePath());
+
+    // Decode each TEX while the next ones are read in the background
+    KTexPrefetcher prefetcher(texPaths, prefetchDepth);
+    for(const QFileInfo& texFile : std::as_const(texFiles))
+    {
+        QString texPath = texFile.absoluteFilePath();
+
+        // Read TEX
+        QByteArray texData;
+        KTex tex;
+        Qx::IoOpReport res = prefetcher.next(texData);
+        if(!res.isFailure())
+            res = readTex(tex, texData, firstMipMap, mipMapCount);
+
+        if(res.isFailure())
+        {
+            CDecompressError err(CDecompressError::CantReadTex, texPath, res.outcomeInfo());
+            mCore.printError(NAME, err);
+            return err;
+        }
+
+        // Extract and write
+        if(auto err = writeImages(tex, texPath, outputDir.absoluteFilePath(texFile.baseName() + '.' + STD_OUTPUT_EXT)); err.isValid())
+            return err;
+    }
 
     // Return success
-    mCore.printMessage(NAME, MSG_SUCCESS);
+    mCore.printMessage(NAME, MSG_BATCH_SUCCESS.arg(texFiles.count()));
     return Qx::Error();
 }
+
+//Public:
+Qx::Error CDecompress::perform()
+{
+    mCore.printMessage(NAME, MSG_INPUT_VALIDATION);
+
+    // Get input
+    QFileInfo input(mParser.value(CL_OPTION_INPUT));
+    if(!input.exists())
+    {
+        CDecompressError err(CDecompressError::InvalidInput);
+        mCore.printError(NAME, err);
+        return err;
+    }
+
+    // Get mip-map selection
+    int firstMipMap, mipMapCount;
+    if(auto err = getMipMapSelection(firstMipMap, mipMapCount); err.isValid())
+        return err;
+
+    return input.isDir() ? decompressBatch(input, firstMipMap, mipMapCount) : decompressSingle(input, firstMipMap, mipMapCount);
+}
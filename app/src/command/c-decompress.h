@@ -16,7 +16,12 @@ public:
     {
         NoError,
         InvalidInput,
-        CantReadTex
+        InvalidOutput,
+        InvalidPrefetch,
+        InvalidMipMap,
+        NoTex,
+        CantReadTex,
+        MissingMipMap
     };
 
 //-Class Variables-------------------------------------------------------------
@@ -24,7 +29,12 @@ private:
     static inline const QHash<Type, QString> ERR_STRINGS{
         {NoError, u""_s},
         {InvalidInput, u"The provided input TEX path is invalid."_s},
-        {CantReadTex, u"Failed to read TEX."_s}
+        {InvalidOutput, u"The provided output directory is invalid."_s},
+        {InvalidPrefetch, u"The provided prefetch depth is invalid."_s},
+        {InvalidMipMap, u"The provided mip-map level is invalid."_s},
+        {NoTex, u"The provided input directory contains no TEX files."_s},
+        {CantReadTex, u"Failed to read TEX."_s},
+        {MissingMipMap, u"The TEX does not contain the requested mip-map level."_s}
     };
 
 //-Instance Variables-------------------------------------------------------------
@@ -57,26 +67,49 @@ class CDecompress : public UntexCommand
 private:
     // Messages
     static inline const QString MSG_SUCCESS = u"Successfully decompressed TEX"_s;
+    static inline const QString MSG_BATCH_SUCCESS = u"Successfully decompressed %1 TEX files"_s;
+
+    // Input
+    static inline const QString TEX_FILTER = u"*.tex"_s;
+
+    // Output
+    static inline const QString MIP_MAP_OUTPUT_NAME = u"%1_mip%2.%3"_s;
 
     // Command line option strings
     static inline const QString CL_OPT_INPUT_S_NAME = u"i"_s;
     static inline const QString CL_OPT_INPUT_L_NAME = u"input"_s;
-    static inline const QString CL_OPT_INPUT_DESC = u"TEX to decompress."_s;
+    static inline const QString CL_OPT_INPUT_DESC = u"TEX, or directory of TEX files, to decompress."_s;
 
     static inline const QString CL_OPT_OUTPUT_S_NAME = u"o"_s;
     static inline const QString CL_OPT_OUTPUT_L_NAME = u"output"_s;
-    static inline const QString CL_OPT_OUTPUT_DESC = u"Path to the resultant image. Defaults to input with PNG extension."_s;
+    static inline const QString CL_OPT_OUTPUT_DESC = u"Path to the resultant image, or directory for the resultant images. Defaults to input with PNG extension, or the input directory."_s;
+
+    static inline const QString CL_OPT_PREFETCH_S_NAME = u"p"_s;
+    static inline const QString CL_OPT_PREFETCH_L_NAME = u"prefetch"_s;
+    static inline const QString CL_OPT_PREFETCH_DESC = u"Number of TEX files to read ahead while decoding when the input is a directory. Defaults to 4."_s;
+
+    static inline const QString CL_OPT_MIP_S_NAME = u"m"_s;
+    static inline const QString CL_OPT_MIP_L_NAME = u"mip"_s;
+    static inline const QString CL_OPT_MIP_DESC = u"Mip-map level to decompress, 0 being the full size image. Defaults to 0."_s;
+
+    static inline const QString CL_OPT_ALL_MIPS_S_NAME = u"a"_s;
+    static inline const QString CL_OPT_ALL_MIPS_L_NAME = u"all-mips"_s;
+    static inline const QString CL_OPT_ALL_MIPS_DESC = u"Decompress every mip-map level, each to its own image with the level appended to its name. Overrides -m."_s;
 
     // Command line options
     static inline const QCommandLineOption CL_OPTION_INPUT{{CL_OPT_INPUT_S_NAME, CL_OPT_INPUT_L_NAME}, CL_OPT_INPUT_DESC, u"input"_s}; // Takes value
     static inline const QCommandLineOption CL_OPTION_OUTPUT{{CL_OPT_OUTPUT_S_NAME, CL_OPT_OUTPUT_L_NAME}, CL_OPT_OUTPUT_DESC, u"output"_s}; // Takes value
-    static inline const QList<const QCommandLineOption*> CL_OPTIONS_SPECIFIC{&CL_OPTION_INPUT, &CL_OPTION_OUTPUT};
+    static inline const QCommandLineOption CL_OPTION_PREFETCH{{CL_OPT_PREFETCH_S_NAME, CL_OPT_PREFETCH_L_NAME}, CL_OPT_PREFETCH_DESC, u"prefetch"_s}; // Takes value
+    static inline const QCommandLineOption CL_OPTION_MIP{{CL_OPT_MIP_S_NAME, CL_OPT_MIP_L_NAME}, CL_OPT_MIP_DESC, u"level"_s}; // Takes value
+    static inline const QCommandLineOption CL_OPTION_ALL_MIPS{{CL_OPT_ALL_MIPS_S_NAME, CL_OPT_ALL_MIPS_L_NAME}, CL_OPT_ALL_MIPS_DESC}; // Boolean option
+    static inline const QList<const QCommandLineOption*> CL_OPTIONS_SPECIFIC{&CL_OPTION_INPUT, &CL_OPTION_OUTPUT, &CL_OPTION_PREFETCH,
+                                                                             &CL_OPTION_MIP, &CL_OPTION_ALL_MIPS};
     static inline const QSet<const QCommandLineOption*> CL_OPTIONS_REQUIRED{&CL_OPTION_INPUT};
 
 public:
     // Meta
     static inline const QString NAME = u"decompress"_s;
-    static inline const QString DESCRIPTION = u"Converts a single TEX to a PNG image."_s;
+    static inline const QString DESCRIPTION = u"Converts a single TEX, or a directory of TEX files, to PNG images."_s;
 
 //-Constructor----------------------------------------------------------------------------------------------------------
 public:
@@ -88,6 +121,12 @@ protected:
     QSet<const QCommandLineOption*> requiredOptions() const override;
     QString name() const override;
 
+private:
+    CDecompressError getMipMapSelection(int& first, int& count) const;
+    Qx::Error writeImages(const KTex& tex, const QString& texPath, const QString& outputPath);
+    Qx::Error decompressSingle(const QFileInfo& input, int firstMipMap, int mipMapCount);
+    Qx::Error decompressBatch(const QFileInfo& input, int firstMipMap, int mipMapCount);
+
 public:
     Qx::Error perform() override;
 };
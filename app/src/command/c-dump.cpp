@@ -48,6 +48,7 @@ Qx::IoOpReport CDump::readTex(KTex& tex, const QString& path) const
 {
     mCore.printMessage(NAME, MSG_READ_TEX);
     KTexReader texReader(path, tex, true);
+    texReader.setReadMode(KTexReader::ReadMode::Mapped); // Data is only dumped, so avoid copying it
     Qx::IoOpReport res = texReader.read();
 
     if(!res.isFailure())
@@ -56,6 +57,18 @@ Qx::IoOpReport CDump::readTex(KTex& tex, const QString& path) const
     return res;
 }
 
+Qx::IoOpReport CDump::readTexInfo(KTex::Info& info, const QString& path) const
+{
+    mCore.printMessage(NAME, MSG_READ_TEX);
+    KTexReader texReader(path, true);
+    Qx::IoOpReport res = texReader.readInfo(info);
+
+    if(!res.isFailure())
+        mCore.printMessage(NAME, MSG_TEX_INFO.arg(info.toString(true)));
+
+    return res;
+}
+
 //Public:
 Qx::Error CDump::perform()
 {
@@ -77,18 +90,23 @@ Qx::Error CDump::perform()
             input.absolutePath() + '/' + input.baseName()
     );
 
-    // Read TEX
+    // Read TEX, skipping its image data entirely if only metadata is needed
+    bool metadataOnly = mParser.isSet(CL_OPTION_METADATA);
     KTex tex;
+    KTex::Info texInfo;
     QString texPath = input.absoluteFilePath();
-    if(auto res = readTex(tex, texPath); res.isFailure())
+    if(auto res = metadataOnly ? readTexInfo(texInfo, texPath) : readTex(tex, texPath); res.isFailure())
     {
         CDumpError err(CDumpError::CantReadTex, texPath, res.outcomeInfo());
         mCore.printError(NAME, err);
         return err;
     }
 
+    if(!metadataOnly)
+        texInfo = tex.metadata();
+
     // Check for empty TEX
-    if(!tex.hasMipMaps())
+    if(texInfo.mipMaps.isEmpty())
     {
         CDumpError err(CDumpError::TexEmpty, texPath);
         mCore.printError(NAME, err);
@@ -104,20 +122,20 @@ Qx::Error CDump::perform()
     }
 
     // Dump
-    for(auto i = 0; i < tex.mipMapCount(); i++)
+    for(auto i = 0; i < texInfo.mipMaps.count(); i++)
     {
-        // Get MM
-        const auto& mm = tex.mipMaps().at(i);
-
-        // Save meta
+        // Save meta, which includes a hash of the data when it was read
         QFile dump(outputDir.absoluteFilePath(META_OUTPUT_TEMPLATE.arg(i)));
-        if(auto res = Qx::writeBytesToFile(dump, mm.jsonMetadata()); res.isFailure())
+        QByteArray meta = metadataOnly ? texInfo.mipMaps.at(i).jsonMetadata() : tex.mipMaps().at(i).jsonMetadata();
+        if(auto res = Qx::writeBytesToFile(dump, meta); res.isFailure())
             return res;
 
+        if(metadataOnly)
+            continue;
 
         // Save data
         dump.setFileName(outputDir.absoluteFilePath(DATA_OUTPUT_TEMPLATE.arg(i)));
-        if(auto res = Qx::writeBytesToFile(dump, mm.imageData()); res.isFailure())
+        if(auto res = Qx::writeBytesToFile(dump, tex.mipMaps().at(i).imageData()); res.isFailure())
             return res;
     }
 
@@ -6,8 +6,7 @@
 
 // Project Includes
 #include "command.h"
-
-class KTex;
+#include "klei/k-tex.h"
 
 class QX_ERROR_TYPE(CDumpError, "CDumpError", 1214)
 {
@@ -75,6 +74,10 @@ private:
     static inline const QString CL_OPT_OUTPUT_L_NAME = u"output"_s;
     static inline const QString CL_OPT_OUTPUT_DESC = u"Path to a directory for the resultant data. Defaults to the basename of the input."_s;
 
+    static inline const QString CL_OPT_METADATA_S_NAME = u"m"_s;
+    static inline const QString CL_OPT_METADATA_L_NAME = u"metadata"_s;
+    static inline const QString CL_OPT_METADATA_DESC = u"Only dump the metadata of each mip-map. Image data is not read."_s;
+
 protected:
     // Messages
     static inline const QString MSG_INPUT_VALIDATION = u"Validating input..."_s;
@@ -87,7 +90,8 @@ protected:
     // Command line options
     static inline const QCommandLineOption CL_OPTION_INPUT{{CL_OPT_INPUT_S_NAME, CL_OPT_INPUT_L_NAME}, CL_OPT_INPUT_DESC, u"input"_s}; // Takes value
     static inline const QCommandLineOption CL_OPTION_OUTPUT{{CL_OPT_OUTPUT_S_NAME, CL_OPT_OUTPUT_L_NAME}, CL_OPT_OUTPUT_DESC, u"output"_s}; // Takes value
-    static inline const QList<const QCommandLineOption*> CL_OPTIONS_SPECIFIC{&CL_OPTION_INPUT, &CL_OPTION_OUTPUT};
+    static inline const QCommandLineOption CL_OPTION_METADATA{{CL_OPT_METADATA_S_NAME, CL_OPT_METADATA_L_NAME}, CL_OPT_METADATA_DESC}; // Boolean option
+    static inline const QList<const QCommandLineOption*> CL_OPTIONS_SPECIFIC{&CL_OPTION_INPUT, &CL_OPTION_OUTPUT, &CL_OPTION_METADATA};
     static inline const QSet<const QCommandLineOption*> CL_OPTIONS_REQUIRED{&CL_OPTION_INPUT};
 
 public:
@@ -110,6 +114,7 @@ private:
     QString name() const override;
 
     Qx::IoOpReport readTex(KTex& tex, const QString& path) const;
+    Qx::IoOpReport readTexInfo(KTex::Info& info, const QString& path) const;
 
 public:
     Qx::Error perform() override;
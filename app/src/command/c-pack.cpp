@@ -74,9 +74,9 @@ Qx::Error CPack::perform()
 {
     mCore.printMessage(NAME, MSG_INPUT_VALIDATION);
 
-    // Get and validate format
-    KTex::Header::PixelFormat outputPixelFormat;
-    if(auto err = getFormat(outputPixelFormat); err.isValid())
+    // Get and validate encoding options
+    ToTexConverter::Options encodeOptions;
+    if(auto err = getEncodeOptions(encodeOptions); err.isValid())
         return err;
 
     // Get input and output
@@ -143,12 +143,9 @@ Qx::Error CPack::perform()
     KAtlasKeyGenerator akg(atlas, inputDir.dirName(), mParser.isSet(CL_OPTION_STRAIGHT));
     KAtlasKey atlasKey = akg.process();
 
-    // Create TEX
-    KTex tex = createTex(atlas.image, outputPixelFormat);
-
-    // Write TEX file
+    // Create and write TEX file
     QString outputTexFilePath(outputDir.absoluteFilePath(atlasKey.atlasFilename()));
-    if(auto res = writeTex(tex, outputTexFilePath); res.isFailure())
+    if(auto res = writeTex(atlas.image, encodeOptions, outputTexFilePath); res.isFailure())
     {
         CPackError err(CPackError::CantWriteAtlas, outputTexFilePath, res.outcomeInfo());
         mCore.printError(NAME, err);
@@ -117,15 +117,35 @@ Qx::Error CUnpack::perform()
         return err;
     }
 
+    // Locate elements ahead of time so that only the parts of the atlas they cover are decoded
+    QSize atlasSize = tex.hasMipMaps() ? QSize(tex.mipMaps().first().width(), tex.mipMaps().first().height()) : QSize();
+    KAtlasKeyParser akp(atlasKey, atlasSize);
+    QMap<QString, QRect> elements = akp.translateElements();
+
+    if(mParser.isSet(CL_OPTION_ELEMENT))
+    {
+        QMap<QString, QRect> selected;
+        for(const QString& elementName : mParser.values(CL_OPTION_ELEMENT))
+        {
+            if(!elements.contains(elementName))
+            {
+                CUnpackError err(CUnpackError::ElementNotFound, elementName);
+                mCore.printError(NAME, err);
+                return err;
+            }
+            selected[elementName] = elements[elementName];
+        }
+        elements = selected;
+    }
+
     // Extract atlas image from TEX
     QImage atlasImage;
-    if(auto err = extractImage(atlasImage, tex, atlasKey.straightAlpha()); err.isValid())
+    if(auto err = extractImage(atlasImage, tex, atlasKey.straightAlpha(), elements.values()); err.isValid())
         return err;
 
     // Create atlas
     mCore.printMessage(NAME, MSG_FORM_ATLAS);
-    KAtlasKeyParser akp(atlasKey, atlasImage);
-    KAtlas atlas = akp.process();
+    KAtlas atlas{.image = atlasImage, .elements = elements}; // Elements were already translated and filtered
 
     // Deatlas
     mCore.printMessage(NAME, MSG_DEATLAS);
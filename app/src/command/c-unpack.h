@@ -17,6 +17,7 @@ public:
         CantReadKey,
         AtlasDoesntExist,
         CantReadAtlas,
+        ElementNotFound,
         CantCreateDir
     };
 
@@ -29,6 +30,7 @@ private:
         {CantReadKey, u"Failed to read atlas key."_s},
         {AtlasDoesntExist, u"The atlas specified by the provided atlas key does not exist."_s},
         {CantReadAtlas, u"Failed to read atlas."_s},
+        {ElementNotFound, u"The atlas key does not contain the requested element."_s},
         {CantCreateDir, u"Failed to create unpack folder."_s}
     };
 
@@ -76,11 +78,16 @@ private:
     static inline const QString CL_OPT_OUTPUT_L_NAME = u"output"_s;
     static inline const QString CL_OPT_OUTPUT_DESC = u"Directory in which to place the resultant folder of unpacked images."_s;
 
+    static inline const QString CL_OPT_ELEMENT_S_NAME = u"e"_s;
+    static inline const QString CL_OPT_ELEMENT_L_NAME = u"element"_s;
+    static inline const QString CL_OPT_ELEMENT_DESC = u"Name of an element to unpack, which can be given multiple times. Defaults to all elements."_s;
+
     // Command line options
     static inline const QCommandLineOption CL_OPTION_INPUT{{CL_OPT_INPUT_S_NAME, CL_OPT_INPUT_L_NAME}, CL_OPT_INPUT_DESC, u"input"_s}; // Takes value
     static inline const QCommandLineOption CL_OPTION_OUTPUT{{CL_OPT_OUTPUT_S_NAME, CL_OPT_OUTPUT_L_NAME}, CL_OPT_OUTPUT_DESC, u"output"_s}; // Takes value
+    static inline const QCommandLineOption CL_OPTION_ELEMENT{{CL_OPT_ELEMENT_S_NAME, CL_OPT_ELEMENT_L_NAME}, CL_OPT_ELEMENT_DESC, u"element"_s}; // Takes value
 
-    static inline const QList<const QCommandLineOption*> CL_OPTIONS_SPECIFIC{&CL_OPTION_INPUT, &CL_OPTION_OUTPUT};
+    static inline const QList<const QCommandLineOption*> CL_OPTIONS_SPECIFIC{&CL_OPTION_INPUT, &CL_OPTION_OUTPUT, &CL_OPTION_ELEMENT};
     static inline const QSet<const QCommandLineOption*> CL_OPTIONS_REQUIRED{&CL_OPTION_INPUT, &CL_OPTION_OUTPUT};
 
 public:
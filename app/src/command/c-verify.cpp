@@ -0,0 +1,279 @@
+// Unit Includes
+#include "c-verify.h"
+
+// Qt Includes
+#include <QDir>
+#include <QDirIterator>
+#include <QThreadPool>
+
+// Qx Includes
+#include <qx/core/qx-json.h>
+#include <qx/io/qx-common-io.h>
+
+// Project Includes
+#include "klei/k-tex.h"
+#include "klei/k-tex-io.h"
+#include "klei/k-atlaskey.h"
+#include "klei/k-xml.h"
+
+//===============================================================================================================
+// UNIT ONLY
+//===============================================================================================================
+namespace
+{
+
+struct Issue
+{
+    QString check;
+    QString details;
+    QX_JSON_STRUCT(check, details);
+};
+
+struct TexResult
+{
+    QString path;
+    bool valid;
+    QList<Issue> issues;
+    QX_JSON_STRUCT(path, valid, issues);
+};
+
+struct Report
+{
+    int checked;
+    int invalid;
+    QList<TexResult> files;
+    QX_JSON_STRUCT(checked, invalid, files);
+};
+
+// Checks
+const QString CHECK_OPEN = u"open"_s;
+const QString CHECK_MAGIC = u"magic"_s;
+const QString CHECK_SPEC = u"spec"_s;
+const QString CHECK_SIZE = u"size"_s;
+const QString CHECK_EXTENT = u"extent"_s;
+const QString CHECK_KEY = u"key"_s;
+
+void verifyKey(TexResult& result, const QFileInfo& texFileInfo, const KTex::Info& texInfo)
+{
+    // Only keys that share the name of the TEX are considered its key
+    QFile keyFile(texFileInfo.absoluteDir().filePath(texFileInfo.completeBaseName() + '.' + KAtlasKey::standardExtension()));
+    if(!keyFile.exists())
+        return;
+
+    KAtlasKey atlasKey;
+    KAtlasKeyReader keyReader(atlasKey, keyFile);
+    if(Qx::XmlStreamReaderError keyReadReport = keyReader.read(); keyReadReport.isValid())
+    {
+        result.issues.append({CHECK_KEY, keyReadReport.text()});
+        return;
+    }
+
+    if(atlasKey.atlasFilename() != texFileInfo.fileName())
+    {
+        result.issues.append({CHECK_KEY, u"Key refers to a different atlas, '%1'."_s.arg(atlasKey.atlasFilename())});
+        return;
+    }
+
+    if(texInfo.mipMaps.isEmpty())
+        return;
+
+    // Elements are stored at pixel centers and rounded, so allow them to be off by up to half a pixel
+    const KTex::MipMapInfo& baseMipMap = texInfo.mipMaps.constFirst();
+    qreal uTolerance = 0.5 / std::max<quint16>(baseMipMap.width, 1);
+    qreal vTolerance = 0.5 / std::max<quint16>(baseMipMap.height, 1);
+    QRectF bounds(QPointF(-uTolerance, -vTolerance), QPointF(1.0 + uTolerance, 1.0 + vTolerance));
+
+    for(auto i = atlasKey.elements().constBegin(); i != atlasKey.elements().constEnd(); i++)
+    {
+        // Orientation varies between tools, so only the area of each element matters
+        if(!bounds.contains(i->normalized()))
+        {
+            QString uvs = u"(%1, %2) - (%3, %4)"_s.arg(i->left()).arg(i->top()).arg(i->right()).arg(i->bottom());
+            result.issues.append({CHECK_KEY, u"Element '%1' lies outside of the atlas: %2."_s.arg(i.key(), uvs)});
+        }
+    }
+}
+
+void verifyTex(TexResult& result)
+{
+    QFile texFile(result.path);
+    if(!texFile.open(QIODevice::ReadOnly))
+    {
+        result.issues.append({CHECK_OPEN, texFile.errorString()});
+        return;
+    }
+
+    // Only the header and metadata table are read, everything else is checked against them
+    KTex::Info texInfo;
+    KTexReader texReader(&texFile);
+    if(Qx::IoOpReport res = texReader.readInfo(texInfo); res.isFailure())
+    {
+        // Narrow down which part of the metadata was rejected
+        texFile.seek(0);
+        if(texFile.read(KTex::Header::MAGIC_NUM.size()) != KTex::Header::MAGIC_NUM.toUtf8())
+            result.issues.append({CHECK_MAGIC, u"Missing magic number."_s});
+        else if(res.result() == Qx::IO_ERR_CURSOR_OOB)
+            result.issues.append({CHECK_EXTENT, u"Header or mip-map metadata is truncated."_s});
+        else
+            result.issues.append({CHECK_SPEC, u"Platform, pixel format, or texture type is unsupported."_s});
+        return;
+    }
+
+    // Data sizes are fixed by pixel format and dimensions
+    if(texInfo.mipMaps.isEmpty())
+        result.issues.append({CHECK_SIZE, u"TEX contains no mip-maps."_s});
+
+    for(qsizetype i = 0; i < texInfo.mipMaps.count(); i++)
+    {
+        const KTex::MipMapInfo& mipMap = texInfo.mipMaps.at(i);
+        quint32 expectedSize = KTex::standardImageDataSize(texInfo.header.pixelFormat(), mipMap.width, mipMap.height);
+        if(mipMap.dataSize != expectedSize)
+        {
+            result.issues.append({CHECK_SIZE, u"Mip-map %1 (%2x%3) has %4 bytes of data instead of %5."_s
+                                                  .arg(i).arg(mipMap.width).arg(mipMap.height).arg(mipMap.dataSize).arg(expectedSize)});
+        }
+    }
+
+    // Mip-map data should account for the rest of the file exactly
+    qint64 dataEnd = texInfo.mipMaps.isEmpty() ? KTex::Header::BYTE_COUNT : texInfo.mipMaps.constLast().dataOffset + texInfo.mipMaps.constLast().dataSize;
+    qint64 fileSize = texFile.size();
+    if(dataEnd > fileSize)
+        result.issues.append({CHECK_EXTENT, u"Mip-map data is truncated by %1 bytes."_s.arg(dataEnd - fileSize)});
+    else if(dataEnd < fileSize)
+        result.issues.append({CHECK_EXTENT, u"There are %1 bytes of trailing data after the last mip-map."_s.arg(fileSize - dataEnd)});
+
+    texFile.close();
+
+    // Check key, if present
+    verifyKey(result, QFileInfo(result.path), texInfo);
+}
+
+}
+
+//===============================================================================================================
+// CVerifyError
+//===============================================================================================================
+
+//-Constructor-------------------------------------------------------------
+//Private:
+CVerifyError::CVerifyError(Type t, const QString& s, const QString& d) :
+    mType(t),
+    mSpecific(s),
+    mDetails(d)
+{}
+
+//-Instance Functions-------------------------------------------------------------
+//Public:
+bool CVerifyError::isValid() const { return mType != NoError; }
+QString CVerifyError::specific() const { return mSpecific; }
+CVerifyError::Type CVerifyError::type() const { return mType; }
+
+//Private:
+Qx::Severity CVerifyError::deriveSeverity() const { return Qx::Critical; }
+quint32 CVerifyError::deriveValue() const { return mType; }
+QString CVerifyError::derivePrimary() const { return ERR_STRINGS.value(mType); }
+QString CVerifyError::deriveSecondary() const { return mSpecific; }
+QString CVerifyError::deriveDetails() const { return mDetails; }
+
+//===============================================================================================================
+// CVerify
+//===============================================================================================================
+
+//-Constructor-------------------------------------------------------------
+//Public:
+CVerify::CVerify(Stex& coreRef) : Command(coreRef) {}
+
+//-Instance Functions-------------------------------------------------------------
+//Private:
+QList<const QCommandLineOption*> CVerify::options() const { return CL_OPTIONS_SPECIFIC + Command::options(); }
+QSet<const QCommandLineOption*> CVerify::requiredOptions() const { return CL_OPTIONS_REQUIRED; }
+QString CVerify::name() const { return NAME; }
+
+QStringList CVerify::findTex(const QFileInfo& input) const
+{
+    if(input.isFile())
+        return {input.absoluteFilePath()};
+
+    QStringList texPaths;
+    QDirIterator texItr(input.absoluteFilePath(), {TEX_FILTER}, QDir::Files, QDirIterator::Subdirectories);
+    while(texItr.hasNext())
+        texPaths.append(texItr.next());
+
+    // Keep the report stable between runs
+    texPaths.sort();
+    return texPaths;
+}
+
+//Public:
+Qx::Error CVerify::perform()
+{
+    // The report alone is printed when it isn't written to a file, so that it can be parsed directly
+    bool reportToFile = mParser.isSet(CL_OPTION_OUTPUT);
+    auto printMessage = [&](const QString& message){ if(reportToFile) mCore.printMessage(NAME, message); };
+    auto printError = [&](const Qx::Error& error){ if(reportToFile) mCore.printError(NAME, error); };
+
+    printMessage(MSG_INPUT_VALIDATION);
+
+    // Get input
+    QFileInfo input(mParser.value(CL_OPTION_INPUT));
+    if(!input.exists())
+    {
+        CVerifyError err(CVerifyError::InvalidInput);
+        mCore.printError(NAME, err);
+        return err;
+    }
+
+    // Find TEX files
+    printMessage(MSG_FIND_TEX);
+    QStringList texPaths = findTex(input);
+
+    // Verify each TEX independently on the pool, each task only touching its own result
+    printMessage(MSG_VERIFY_TEX.arg(texPaths.count()));
+    Report report{static_cast<int>(texPaths.count()), 0, {}};
+    report.files.resize(texPaths.count());
+    TexResult* results = report.files.data();
+
+    QThreadPool* pool = QThreadPool::globalInstance();
+    for(qsizetype i = 0; i < texPaths.count(); i++)
+    {
+        results[i].path = texPaths.at(i);
+        pool->start([result = &results[i]]{ verifyTex(*result); });
+    }
+    pool->waitForDone();
+
+    for(TexResult& result : report.files)
+    {
+        result.valid = result.issues.isEmpty();
+        if(!result.valid)
+            report.invalid++;
+    }
+
+    // Output report
+    QByteArray reportJson;
+    Qx::serializeJson(reportJson, report);
+
+    if(reportToFile)
+    {
+        printMessage(MSG_WRITE_REPORT);
+        QFile reportFile(mParser.value(CL_OPTION_OUTPUT));
+        if(auto res = Qx::writeBytesToFile(reportFile, reportJson); res.isFailure())
+        {
+            CVerifyError err(CVerifyError::CantWriteReport, reportFile.fileName(), res.outcomeInfo());
+            mCore.printError(NAME, err);
+            return err;
+        }
+    }
+    else
+        mCore.printVerbatim(QString::fromUtf8(reportJson) + '\n');
+
+    // Fail if anything didn't pass so that this can gate scripts
+    if(report.invalid > 0)
+    {
+        CVerifyError err(CVerifyError::InvalidTex, u"%1 of %2"_s.arg(report.invalid).arg(report.checked));
+        printError(err);
+        return err;
+    }
+
+    printMessage(MSG_SUCCESS.arg(report.checked));
+    return Qx::Error();
+}
@@ -0,0 +1,107 @@
+#ifndef CVERIFY_H
+#define CVERIFY_H
+
+// Qt Includes
+#include <QFileInfo>
+
+// Project Includes
+#include "command.h"
+
+class QX_ERROR_TYPE(CVerifyError, "CVerifyError", 1217)
+{
+    friend class CVerify;
+//-Class Enums-------------------------------------------------------------
+public:
+    enum Type
+    {
+        NoError,
+        InvalidInput,
+        CantWriteReport,
+        InvalidTex
+    };
+
+//-Class Variables-------------------------------------------------------------
+private:
+    static inline const QHash<Type, QString> ERR_STRINGS{
+        {NoError, u""_s},
+        {InvalidInput, u"The provided input path is invalid."_s},
+        {CantWriteReport, u"Failed to write the verification report."_s},
+        {InvalidTex, u"One or more TEX files failed verification."_s}
+    };
+
+//-Instance Variables-------------------------------------------------------------
+private:
+    Type mType;
+    QString mSpecific;
+    QString mDetails;
+
+//-Constructor-------------------------------------------------------------
+private:
+    CVerifyError(Type t = NoError, const QString& s = {}, const QString& d = {});
+
+//-Instance Functions-------------------------------------------------------------
+public:
+    bool isValid() const;
+    Type type() const;
+    QString specific() const;
+
+private:
+    Qx::Severity deriveSeverity() const override;
+    quint32 deriveValue() const override;
+    QString derivePrimary() const override;
+    QString deriveSecondary() const override;
+    QString deriveDetails() const override;
+};
+
+class CVerify : public Command
+{
+//-Class Variables------------------------------------------------------------------------------------------------------
+private:
+    // Messages
+    static inline const QString MSG_INPUT_VALIDATION = u"Validating input..."_s;
+    static inline const QString MSG_FIND_TEX = u"Searching for TEX files..."_s;
+    static inline const QString MSG_VERIFY_TEX = u"Verifying %1 TEX file(s)..."_s;
+    static inline const QString MSG_WRITE_REPORT = u"Writing report..."_s;
+    static inline const QString MSG_SUCCESS = u"All %1 TEX file(s) passed verification"_s;
+
+    // Input
+    static inline const QString TEX_FILTER = u"*.tex"_s;
+
+    // Command line option strings
+    static inline const QString CL_OPT_INPUT_S_NAME = u"i"_s;
+    static inline const QString CL_OPT_INPUT_L_NAME = u"input"_s;
+    static inline const QString CL_OPT_INPUT_DESC = u"TEX, or directory to search recursively for TEX files, to verify."_s;
+
+    static inline const QString CL_OPT_OUTPUT_S_NAME = u"o"_s;
+    static inline const QString CL_OPT_OUTPUT_L_NAME = u"output"_s;
+    static inline const QString CL_OPT_OUTPUT_DESC = u"Path to the resultant JSON report. Defaults to printing the report alone to stdout."_s;
+
+    // Command line options
+    static inline const QCommandLineOption CL_OPTION_INPUT{{CL_OPT_INPUT_S_NAME, CL_OPT_INPUT_L_NAME}, CL_OPT_INPUT_DESC, u"input"_s}; // Takes value
+    static inline const QCommandLineOption CL_OPTION_OUTPUT{{CL_OPT_OUTPUT_S_NAME, CL_OPT_OUTPUT_L_NAME}, CL_OPT_OUTPUT_DESC, u"output"_s}; // Takes value
+    static inline const QList<const QCommandLineOption*> CL_OPTIONS_SPECIFIC{&CL_OPTION_INPUT, &CL_OPTION_OUTPUT};
+    static inline const QSet<const QCommandLineOption*> CL_OPTIONS_REQUIRED{&CL_OPTION_INPUT};
+
+public:
+    // Meta
+    static inline const QString NAME = u"verify"_s;
+    static inline const QString DESCRIPTION = u"Checks the integrity of TEX files, and their atlas keys, without decoding them."_s;
+
+//-Constructor----------------------------------------------------------------------------------------------------------
+public:
+    CVerify(Stex& coreRef);
+
+//-Instance Functions------------------------------------------------------------------------------------------------------
+private:
+    QList<const QCommandLineOption*> options() const override;
+    QSet<const QCommandLineOption*> requiredOptions() const override;
+    QString name() const override;
+
+    QStringList findTex(const QFileInfo& input) const;
+
+public:
+    Qx::Error perform() override;
+};
+REGISTER_COMMAND(CVerify::NAME, CVerify, CVerify::DESCRIPTION);
+
+#endif // CVERIFY_H
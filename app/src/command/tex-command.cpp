@@ -3,11 +3,50 @@
 
 // Qt Includes
 #include <QImageReader>
+#include <QBuffer>
+
+// Standard Library Includes
+#include <optional>
+
+// Qx Includes
+#include <qx/core/qx-json.h>
+#include <qx/io/qx-common-io.h>
 
 // Project Includes
 #include "conversion.h"
+#include "encode-cache.h"
 #include "klei/k-tex-io.h"
 
+//===============================================================================================================
+// UNIT ONLY
+//===============================================================================================================
+namespace
+{
+
+struct MipMapHash
+{
+    quint16 width;
+    quint16 height;
+    QString xxh64;
+    QX_JSON_STRUCT(width, height, xxh64);
+};
+
+struct TexHashes
+{
+    QList<MipMapHash> mipMaps;
+    QX_JSON_STRUCT(mipMaps);
+};
+
+Qx::IoOpReport writeHashFile(const TexHashes& hashes, const QString& path)
+{
+    QByteArray hashJson;
+    Qx::serializeJson(hashJson, hashes);
+    QFile hashFile(path);
+    return Qx::writeBytesToFile(hashFile, hashJson);
+}
+
+}
+
 //===============================================================================================================
 // TexCommandError
 //===============================================================================================================
@@ -43,9 +82,7 @@ TexCommand::TexCommand(Stex& coreRef) : Command(coreRef)
 {}
 
 //-Instance Functions-------------------------------------------------------------
-//Protected:
-QList<const QCommandLineOption*> TexCommand::options() const { return CL_OPTIONS_SPECIFIC + Command::options(); }
-
+//Private:
 TexCommandError TexCommand::getFormat(KTex::Header::PixelFormat& format) const
 {
     format = KTex::Header::PixelFormat::DXT5;
@@ -65,29 +102,182 @@ TexCommandError TexCommand::getFormat(KTex::Header::PixelFormat& format) const
     return TexCommandError();
 }
 
-KTex TexCommand::createTex(const QImage& image, KTex::Header::PixelFormat format) const
+TexCommandError TexCommand::getQuality(ToTexConverter::Quality& quality) const
 {
-    // This could get the format itself, but we want that input validated before any computation takes place
-    mCore.printMessage(NAME, MSG_CREATE_TEX);
-    ToTexConverter::Options ttco;
-    ttco.generateMipMaps = !mParser.isSet(CL_OPTION_UNOPT);
-    ttco.premultiplyAlpha = !mParser.isSet(CL_OPTION_STRAIGHT);
-    ttco.pixelFormat = format;
+    quality = ToTexConverter::Quality::Normal;
+
+    if(!mParser.isSet(CL_OPTION_QUALITY))
+        return TexCommandError();
+
+    QString qualityStr = mParser.value(CL_OPTION_QUALITY);
+    if(!QUALITY_MAP.contains(qualityStr))
+    {
+        TexCommandError err(TexCommandError::InvalidQuality);
+        mCore.printError(NAME, err);
+        return err;
+    }
+
+    quality = QUALITY_MAP[qualityStr];
+    return TexCommandError();
+}
 
-    ToTexConverter ttc(image, ttco);
-    KTex tex = ttc.convert();
+TexCommandError TexCommand::getCodec(const BlockCodec*& codec, KTex::Header::PixelFormat format) const
+{
+    codec = nullptr;
 
-    // Show metadata
-    mCore.printMessage(NAME, MSG_TEX_INFO.arg(tex.info(true)));
+    if(!mParser.isSet(CL_OPTION_CODEC))
+        return TexCommandError();
 
-    return tex;
+    QString codecStr = mParser.value(CL_OPTION_CODEC);
+    const BlockCodec* namedCodec = BlockCodec::named(codecStr);
+    if(!namedCodec)
+    {
+        TexCommandError err(TexCommandError::InvalidCodec);
+        mCore.printError(NAME, err);
+        return err;
+    }
+
+    if(!namedCodec->encodes(format))
+    {
+        TexCommandError err(TexCommandError::UnsupportedCodec, codecStr);
+        mCore.printError(NAME, err);
+        return err;
+    }
+
+    codec = namedCodec;
+    return TexCommandError();
 }
 
-Qx::IoOpReport TexCommand::writeTex(const KTex& tex, const QString& path) const
+Qx::IoOpReport TexCommand::writeCachedTex(const QByteArray& texData, const QString& path) const
 {
     mCore.printMessage(NAME, MSG_WRITE_TEX);
-    KTexWriter texWriter(tex, path);
-    return texWriter.write();
+    QFile texFile(path);
+    Qx::IoOpReport res = Qx::writeBytesToFile(texFile, texData);
+    if(res.isFailure() || !mParser.isSet(CL_OPTION_HASH))
+        return res;
+
+    // The mip-maps only need to be viewed to be hashed
+    KTex tex;
+    QBuffer texBuffer;
+    texBuffer.setData(texData);
+    KTexReader texReader(&texBuffer, tex);
+    texReader.setReadMode(KTexReader::ReadMode::Mapped);
+    if((res = texReader.read()).isFailure())
+        return res;
+
+    TexHashes hashes;
+    for(const KTex::MipMapImage& mipMap : tex.mipMaps())
+        hashes.mipMaps.append({mipMap.width(), mipMap.height(), mipMap.dataHash()});
+
+    mCore.printMessage(NAME, MSG_WRITE_HASHES);
+    return writeHashFile(hashes, HASH_OUTPUT_TEMPLATE.arg(path));
+}
+
+TexCommandError TexCommand::getThreads(int& threads) const
+{
+    threads = 0;
+
+    if(!mParser.isSet(CL_OPTION_THREADS))
+        return TexCommandError();
+
+    bool validThreads;
+    threads = mParser.value(CL_OPTION_THREADS).toInt(&validThreads);
+    if(!validThreads || threads < 1)
+    {
+        TexCommandError err(TexCommandError::InvalidThreads);
+        mCore.printError(NAME, err);
+        return err;
+    }
+
+    return TexCommandError();
+}
+
+//Protected:
+QList<const QCommandLineOption*> TexCommand::options() const { return CL_OPTIONS_SPECIFIC + Command::options(); }
+
+TexCommandError TexCommand::getEncodeOptions(ToTexConverter::Options& options) const
+{
+    options = ToTexConverter::Options();
+    options.generateMipMaps = !mParser.isSet(CL_OPTION_UNOPT);
+    options.srgbMipMaps = mParser.isSet(CL_OPTION_SRGB);
+    options.premultiplyAlpha = !mParser.isSet(CL_OPTION_STRAIGHT);
+
+    if(auto err = getFormat(options.pixelFormat); err.isValid())
+        return err;
+
+    if(auto err = getQuality(options.quality); err.isValid())
+        return err;
+
+    if(auto err = getCodec(options.codec, options.pixelFormat); err.isValid())
+        return err;
+
+    return getThreads(options.threads);
+}
+
+Qx::IoOpReport TexCommand::writeTex(const QImage& image, const ToTexConverter::Options& options, const QString& path) const
+{
+    // This could get the options itself, but we want that input validated before any computation takes place
+    mCore.printMessage(NAME, MSG_CREATE_TEX);
+    ToTexConverter ttc(image, options);
+
+    // Show metadata, which is fully known before encoding
+    KTex::Info texInfo = ttc.metadata();
+    mCore.printMessage(NAME, MSG_TEX_INFO.arg(texInfo.toString(true)));
+
+    // Reuse an earlier encode of the same image with the same options if there is one
+    std::optional<EncodeCache> cache;
+    QString cacheKey;
+    if(mParser.isSet(CL_OPTION_CACHE))
+    {
+        cache.emplace(mParser.value(CL_OPTION_CACHE));
+        cacheKey = EncodeCache::key(image, options);
+
+        QByteArray cachedTex;
+        if(cache->fetch(cacheKey, texInfo, cachedTex))
+        {
+            mCore.printMessage(NAME, MSG_CACHE_HIT);
+            return writeCachedTex(cachedTex, path);
+        }
+    }
+
+    if(const BlockCodec* codec = options.codec ? options.codec : BlockCodec::preferredEncoder(options.pixelFormat))
+        mCore.printMessage(NAME, MSG_CODEC.arg(codec->name(), codec->kernel()));
+
+    // Write each mip-map as soon as it's encoded
+    mCore.printMessage(NAME, MSG_WRITE_TEX);
+    KTexStreamWriter texWriter(texInfo, path);
+    Qx::IoOpReport res;
+    if((res = texWriter.open()).isFailure())
+        return res;
+
+    // Hash each mip-map while its data is still at hand
+    bool hash = mParser.isSet(CL_OPTION_HASH);
+    TexHashes hashes;
+
+    ttc.convert([&](KTex::MipMapImage&& mipMap){
+        if(hash)
+            hashes.mipMaps.append({mipMap.width(), mipMap.height(), mipMap.dataHash()});
+
+        res = texWriter.writeMipMap(mipMap);
+        return !res.isFailure();
+    });
+
+    if(res.isFailure())
+        return res;
+
+    if((res = texWriter.close()).isFailure())
+        return res;
+
+    // A failure here only costs a future encode, so carry on
+    if(cache && !cache->store(cacheKey, path))
+        mCore.printMessage(NAME, MSG_CACHE_STORE_FAILED);
+
+    if(!hash)
+        return res;
+
+    // Write hashes
+    mCore.printMessage(NAME, MSG_WRITE_HASHES);
+    return writeHashFile(hashes, HASH_OUTPUT_TEMPLATE.arg(path));
 }
 
 TexCommandError TexCommand::readImage(QImage& image, const QString& path) const
@@ -7,6 +7,7 @@
 // Project Includes
 #include "command.h"
 #include "klei/k-tex.h"
+#include "conversion.h"
 
 class QX_ERROR_TYPE(TexCommandError, "TexCommandError", 1211)
 {
@@ -17,6 +18,10 @@ public:
     {
         NoError,
         InvalidFormat,
+        InvalidQuality,
+        InvalidCodec,
+        UnsupportedCodec,
+        InvalidThreads,
         CantReadImage
     };
 
@@ -25,6 +30,10 @@ private:
     static inline const QHash<Type, QString> ERR_STRINGS{
         {NoError, u""_s},
         {InvalidFormat, u"The provided output pixel format is invalid."_s},
+        {InvalidQuality, u"The provided encoding quality is invalid."_s},
+        {InvalidCodec, u"The provided codec is invalid."_s},
+        {UnsupportedCodec, u"The provided codec cannot encode the chosen pixel format."_s},
+        {InvalidThreads, u"The provided thread count is invalid."_s},
         {CantReadImage, u"Failed to read image."_s}
     };
 
@@ -66,10 +75,23 @@ private:
         {u"etc2eac"_s, KTex::Header::PixelFormat::ETC2EAC}
     };
 
+    static inline const QMap<QString, ToTexConverter::Quality> QUALITY_MAP = {
+        {u"fast"_s, ToTexConverter::Quality::Fast},
+        {u"normal"_s, ToTexConverter::Quality::Normal},
+        {u"best"_s, ToTexConverter::Quality::Best}
+    };
+
     // Messages
     static inline const QString MSG_CREATE_TEX = u"Creating TEX..."_s;
+    static inline const QString MSG_CODEC = u"Encoding with %1 (%2)"_s;
     static inline const QString MSG_TEX_INFO =  u"TEX Info:\n%1"_s;
     static inline const QString MSG_WRITE_TEX = u"Writing TEX..."_s;
+    static inline const QString MSG_WRITE_HASHES = u"Writing mip-map hashes..."_s;
+    static inline const QString MSG_CACHE_HIT = u"Found identical encode in cache, reusing it"_s;
+    static inline const QString MSG_CACHE_STORE_FAILED = u"Could not add the TEX to the cache"_s;
+
+    // Output
+    static inline const QString HASH_OUTPUT_TEMPLATE = u"%1.xxh64.json"_s;
 
     // Command line option strings
     static inline const QString CL_OPT_STRAIGHT_S_NAME = u"s"_s;
@@ -80,12 +102,40 @@ private:
     static inline const QString CL_OPT_UNOPT_L_NAME = u"unoptimized"_s;
     static inline const QString CL_OPT_UNOPT_DESC = u"Do not generate smoothed mipmaps."_s;
 
+    static inline const QString CL_OPT_SRGB_S_NAME = u"g"_s;
+    static inline const QString CL_OPT_SRGB_L_NAME = u"srgb"_s;
+    static inline const QString CL_OPT_SRGB_DESC = u"Treat color as sRGB and average it in linear light when generating mipmaps."_s;
+
     static inline const QString CL_OPT_FORMAT_S_NAME = u"f"_s;
     static inline const QString CL_OPT_FORMAT_L_NAME = u"format"_s;
     static inline const QString CL_OPT_FORMAT_DESC = u"Pixel format to use when encoding to TEX. <"_s +
                                                      PIXEL_FORMAT_MAP.keys().join(u" | "_s) + u">. "_s +
                                                      u"Defaults to DXT5."_s;
 
+    static inline const QString CL_OPT_QUALITY_S_NAME = u"q"_s;
+    static inline const QString CL_OPT_QUALITY_L_NAME = u"quality"_s;
+    static inline const QString CL_OPT_QUALITY_DESC = u"Encoding speed/accuracy trade-off for the block compressed pixel formats (DXT & ETC2EAC). <"_s +
+                                                      QUALITY_MAP.keys().join(u" | "_s) + u">. "_s +
+                                                      u"Defaults to normal."_s;
+
+    static inline const QString CL_OPT_CODEC_S_NAME = u"c"_s;
+    static inline const QString CL_OPT_CODEC_L_NAME = u"codec"_s;
+    static inline const QString CL_OPT_CODEC_DESC = u"Codec to encode the block compressed pixel formats with. <"_s +
+                                                    BlockCodec::encoderNames().join(u" | "_s) + u">. "_s +
+                                                    u"Defaults to the preferred codec for the pixel format."_s;
+
+    static inline const QString CL_OPT_THREADS_S_NAME = u"t"_s;
+    static inline const QString CL_OPT_THREADS_L_NAME = u"threads"_s;
+    static inline const QString CL_OPT_THREADS_DESC = u"Maximum number of threads to encode with. Defaults to all available."_s;
+
+    static inline const QString CL_OPT_CACHE_S_NAME = u"k"_s;
+    static inline const QString CL_OPT_CACHE_L_NAME = u"cache-dir"_s;
+    static inline const QString CL_OPT_CACHE_DESC = u"Directory in which to keep encoded TEX files, which are reused when the same image is encoded with the same options again."_s;
+
+    static inline const QString CL_OPT_HASH_S_NAME = u"x"_s;
+    static inline const QString CL_OPT_HASH_L_NAME = u"hash"_s;
+    static inline const QString CL_OPT_HASH_DESC = u"Write an XXH64 hash of each mip-map's data to a JSON file alongside the TEX."_s;
+
 protected:
     // Messages
     static inline const QString MSG_INPUT_VALIDATION = u"Validating input..."_s;
@@ -93,9 +143,17 @@ protected:
     // Command line options
     static inline const QCommandLineOption CL_OPTION_STRAIGHT{{CL_OPT_STRAIGHT_S_NAME, CL_OPT_STRAIGHT_L_NAME}, CL_OPT_STRAIGHT_DESC}; // Boolean option
     static inline const QCommandLineOption CL_OPTION_UNOPT{{CL_OPT_UNOPT_S_NAME, CL_OPT_UNOPT_L_NAME}, CL_OPT_UNOPT_DESC}; // Boolean option
+    static inline const QCommandLineOption CL_OPTION_SRGB{{CL_OPT_SRGB_S_NAME, CL_OPT_SRGB_L_NAME}, CL_OPT_SRGB_DESC}; // Boolean option
     static inline const QCommandLineOption CL_OPTION_FORMAT{{CL_OPT_FORMAT_S_NAME, CL_OPT_FORMAT_L_NAME}, CL_OPT_FORMAT_DESC, u"format"_s}; // Takes value
+    static inline const QCommandLineOption CL_OPTION_QUALITY{{CL_OPT_QUALITY_S_NAME, CL_OPT_QUALITY_L_NAME}, CL_OPT_QUALITY_DESC, u"quality"_s}; // Takes value
+    static inline const QCommandLineOption CL_OPTION_CODEC{{CL_OPT_CODEC_S_NAME, CL_OPT_CODEC_L_NAME}, CL_OPT_CODEC_DESC, u"codec"_s}; // Takes value
+    static inline const QCommandLineOption CL_OPTION_THREADS{{CL_OPT_THREADS_S_NAME, CL_OPT_THREADS_L_NAME}, CL_OPT_THREADS_DESC, u"threads"_s}; // Takes value
+    static inline const QCommandLineOption CL_OPTION_CACHE{{CL_OPT_CACHE_S_NAME, CL_OPT_CACHE_L_NAME}, CL_OPT_CACHE_DESC, u"cache-dir"_s}; // Takes value
+    static inline const QCommandLineOption CL_OPTION_HASH{{CL_OPT_HASH_S_NAME, CL_OPT_HASH_L_NAME}, CL_OPT_HASH_DESC}; // Boolean option
 
-    static inline const QList<const QCommandLineOption*> CL_OPTIONS_SPECIFIC{&CL_OPTION_STRAIGHT, &CL_OPTION_UNOPT, &CL_OPTION_FORMAT};
+    static inline const QList<const QCommandLineOption*> CL_OPTIONS_SPECIFIC{&CL_OPTION_STRAIGHT, &CL_OPTION_UNOPT, &CL_OPTION_SRGB, &CL_OPTION_FORMAT,
+                                                                             &CL_OPTION_QUALITY, &CL_OPTION_CODEC, &CL_OPTION_THREADS, &CL_OPTION_CACHE,
+                                                                             &CL_OPTION_HASH};
 
 public:
     // Meta
@@ -110,12 +168,18 @@ public:
     virtual ~TexCommand() = default;
 
 //-Instance Functions------------------------------------------------------------------------------------------------------
+private:
+    TexCommandError getFormat(KTex::Header::PixelFormat& format) const;
+    TexCommandError getQuality(ToTexConverter::Quality& quality) const;
+    TexCommandError getCodec(const BlockCodec*& codec, KTex::Header::PixelFormat format) const;
+    Qx::IoOpReport writeCachedTex(const QByteArray& texData, const QString& path) const;
+    TexCommandError getThreads(int& threads) const;
+
 protected:
     virtual QList<const QCommandLineOption*> options() const override;
-    TexCommandError getFormat(KTex::Header::PixelFormat& format) const;
+    TexCommandError getEncodeOptions(ToTexConverter::Options& options) const;
     TexCommandError readImage(QImage& image, const QString& path) const;
-    KTex createTex(const QImage& image, KTex::Header::PixelFormat format) const;
-    Qx::IoOpReport writeTex(const KTex& tex, const QString& path) const;
+    Qx::IoOpReport writeTex(const QImage& image, const ToTexConverter::Options& options, const QString& path) const;
 
 };
 
@@ -6,7 +6,6 @@
 
 // Project Includes
 #include "klei/k-tex-io.h"
-#include "conversion.h"
 
 //===============================================================================================================
 // UntexCommandError
@@ -43,27 +42,68 @@ UntexCommand::UntexCommand(Stex& coreRef) : Command(coreRef)
 {}
 
 //-Instance Functions-------------------------------------------------------------
-//Protected:
-QList<const QCommandLineOption*> UntexCommand::options() const { return CL_OPTIONS_SPECIFIC + Command::options(); }
-
-Qx::IoOpReport UntexCommand::readTex(KTex& tex, const QString& path) const
+//Private:
+Qx::IoOpReport UntexCommand::readTex(KTexReader& texReader, int firstMipMap, int mipMapCount) const
 {
     mCore.printMessage(NAME, MSG_READ_TEX);
-    KTexReader texReader(path, tex);
+    texReader.setReadMode(KTexReader::ReadMode::Mapped); // Decoding only reads the data, so avoid copying it
+    texReader.setMipMapSelection(firstMipMap, mipMapCount); // Only the images that are converted
     Qx::IoOpReport res = texReader.read();
 
     if(!res.isFailure())
-        mCore.printMessage(NAME, MSG_TEX_INFO.arg(tex.info(true)));
+        mCore.printMessage(NAME, MSG_TEX_INFO.arg(texReader.metadata().toString(true)));
 
     return res;
 }
 
-UntexCommandError UntexCommand::extractImage(QImage& mainImage, const KTex& tex, bool forceStraight) const
+UntexCommandError UntexCommand::getThreads(int& threads) const
 {
-    mCore.printMessage(NAME, MSG_EXTRACT_IMAGE);
+    threads = 0;
 
-    mainImage = QImage();
+    if(!mParser.isSet(CL_OPTION_THREADS))
+        return UntexCommandError();
+
+    bool validThreads;
+    threads = mParser.value(CL_OPTION_THREADS).toInt(&validThreads);
+    if(!validThreads || threads < 1)
+    {
+        UntexCommandError err(UntexCommandError::InvalidThreads);
+        mCore.printError(NAME, err);
+        return err;
+    }
+
+    return UntexCommandError();
+}
+
+UntexCommandError UntexCommand::getCodec(const BlockCodec*& codec, KTex::Header::PixelFormat format) const
+{
+    codec = nullptr;
+
+    if(!mParser.isSet(CL_OPTION_CODEC))
+        return UntexCommandError();
 
+    QString codecStr = mParser.value(CL_OPTION_CODEC);
+    const BlockCodec* namedCodec = BlockCodec::named(codecStr);
+    if(!namedCodec)
+    {
+        UntexCommandError err(UntexCommandError::InvalidCodec);
+        mCore.printError(NAME, err);
+        return err;
+    }
+
+    if(!namedCodec->decodes(format))
+    {
+        UntexCommandError err(UntexCommandError::UnsupportedCodec, codecStr);
+        mCore.printError(NAME, err);
+        return err;
+    }
+
+    codec = namedCodec;
+    return UntexCommandError();
+}
+
+UntexCommandError UntexCommand::getConverterOptions(FromTexConverter::Options& options, const KTex& tex, bool forceStraight) const
+{
     // Check for empty TEX
     if(!tex.hasMipMaps())
     {
@@ -72,11 +112,68 @@ UntexCommandError UntexCommand::extractImage(QImage& mainImage, const KTex& tex,
         return err;
     }
 
+    options.demultiplyAlpha = !mParser.isSet(CL_OPTION_STRAIGHT) && !forceStraight;
+    if(auto err = getThreads(options.threads); err.isValid())
+        return err;
+
+    auto pxFormat = tex.header().pixelFormat();
+    if(auto err = getCodec(options.codec, pxFormat); err.isValid())
+        return err;
+
+    if(const BlockCodec* codec = options.codec ? options.codec : BlockCodec::preferredDecoder(pxFormat))
+        mCore.printMessage(NAME, MSG_CODEC.arg(codec->name(), codec->kernel()));
+
+    return UntexCommandError();
+}
+
+//Protected:
+QList<const QCommandLineOption*> UntexCommand::options() const { return CL_OPTIONS_SPECIFIC + Command::options(); }
+
+Qx::IoOpReport UntexCommand::readTex(KTex& tex, const QString& path, int firstMipMap, int mipMapCount) const
+{
+    KTexReader texReader(path, tex);
+    return readTex(texReader, firstMipMap, mipMapCount);
+}
+
+Qx::IoOpReport UntexCommand::readTex(KTex& tex, const QByteArray& data, int firstMipMap, int mipMapCount) const
+{
+    // The buffer only holds a shallow copy of the data, which the TEX then views
+    QBuffer texBuffer;
+    texBuffer.setData(data);
+    KTexReader texReader(&texBuffer, tex);
+    return readTex(texReader, firstMipMap, mipMapCount);
+}
+
+UntexCommandError UntexCommand::extractImage(QImage& mainImage, const KTex& tex, bool forceStraight, const QList<QRect>& regions) const
+{
+    mCore.printMessage(NAME, MSG_EXTRACT_IMAGE);
+
+    mainImage = QImage();
+
     // Get and convert
     FromTexConverter::Options ftco;
-    ftco.demultiplyAlpha = !mParser.isSet(CL_OPTION_STRAIGHT) && !forceStraight;
+    if(auto err = getConverterOptions(ftco, tex, forceStraight); err.isValid())
+        return err;
+
+    FromTexConverter ftc(tex, ftco);
+    mainImage = ftc.convert(regions);
+
+    return UntexCommandError();
+}
+
+UntexCommandError UntexCommand::extractImages(QList<QImage>& images, const KTex& tex) const
+{
+    mCore.printMessage(NAME, MSG_EXTRACT_IMAGES.arg(tex.mipMapCount()));
+
+    images.clear();
+
+    // Get and convert
+    FromTexConverter::Options ftco;
+    if(auto err = getConverterOptions(ftco, tex); err.isValid())
+        return err;
+
     FromTexConverter ftc(tex, ftco);
-    mainImage = ftc.convert();
+    images = ftc.convertAll();
 
     return UntexCommandError();
 }
@@ -6,6 +6,7 @@
 
 // Project Includes
 #include "command.h"
+#include "conversion.h"
 
 class QX_ERROR_TYPE(UntexCommandError, "UntexCommandError", 1212)
 {
@@ -16,6 +17,9 @@ public:
     {
         NoError,
         TexEmpty,
+        InvalidThreads,
+        InvalidCodec,
+        UnsupportedCodec,
         CantWriteImage
     };
 
@@ -24,6 +28,9 @@ private:
     static inline const QHash<Type, QString> ERR_STRINGS{
         {NoError, u""_s},
         {TexEmpty, u"The TEX contained no mip-maps."_s},
+        {InvalidThreads, u"The provided thread count is invalid."_s},
+        {InvalidCodec, u"The provided codec is invalid."_s},
+        {UnsupportedCodec, u"The provided codec cannot decode the TEX's pixel format."_s},
         {CantWriteImage, u"Failed to write output image."_s}
     };
 
@@ -51,7 +58,7 @@ private:
     QString deriveDetails() const override;
 };
 
-class KTex;
+class KTexReader;
 
 class UntexCommand : public Command
 {
@@ -61,12 +68,24 @@ private:
     static inline const QString MSG_READ_TEX = u"Reading TEX..."_s;
     static inline const QString MSG_TEX_INFO =  u"TEX Info:\n%1"_s;
     static inline const QString MSG_EXTRACT_IMAGE = u"Extracting primary TEX image..."_s;
+    static inline const QString MSG_EXTRACT_IMAGES = u"Extracting %1 TEX images..."_s;
+    static inline const QString MSG_CODEC = u"Decoding with %1 (%2)"_s;
 
     // Command line option strings
     static inline const QString CL_OPT_STRAIGHT_S_NAME = u"s"_s;
     static inline const QString CL_OPT_STRAIGHT_L_NAME = u"straight"_s;
     static inline const QString CL_OPT_STRAIGHT_DESC = u"Specify that the alpha information within the input TEX is straight, do not de-multiply."_s;
 
+    static inline const QString CL_OPT_THREADS_S_NAME = u"t"_s;
+    static inline const QString CL_OPT_THREADS_L_NAME = u"threads"_s;
+    static inline const QString CL_OPT_THREADS_DESC = u"Maximum number of threads to decode with. Defaults to all available."_s;
+
+    static inline const QString CL_OPT_CODEC_S_NAME = u"c"_s;
+    static inline const QString CL_OPT_CODEC_L_NAME = u"codec"_s;
+    static inline const QString CL_OPT_CODEC_DESC = u"Codec to decode the block compressed pixel formats with. <"_s +
+                                                    BlockCodec::decoderNames().join(u" | "_s) + u">. "_s +
+                                                    u"Defaults to the preferred codec for the pixel format."_s;
+
 protected:
     // Messages
     static inline const QString MSG_INPUT_VALIDATION = u"Validating input..."_s;
@@ -76,8 +95,10 @@ protected:
 
     // Command line options
     static inline const QCommandLineOption CL_OPTION_STRAIGHT{{CL_OPT_STRAIGHT_S_NAME, CL_OPT_STRAIGHT_L_NAME}, CL_OPT_STRAIGHT_DESC}; // Boolean option
+    static inline const QCommandLineOption CL_OPTION_THREADS{{CL_OPT_THREADS_S_NAME, CL_OPT_THREADS_L_NAME}, CL_OPT_THREADS_DESC, u"threads"_s}; // Takes value
+    static inline const QCommandLineOption CL_OPTION_CODEC{{CL_OPT_CODEC_S_NAME, CL_OPT_CODEC_L_NAME}, CL_OPT_CODEC_DESC, u"codec"_s}; // Takes value
 
-    static inline const QList<const QCommandLineOption*> CL_OPTIONS_SPECIFIC{&CL_OPTION_STRAIGHT};
+    static inline const QList<const QCommandLineOption*> CL_OPTIONS_SPECIFIC{&CL_OPTION_STRAIGHT, &CL_OPTION_THREADS, &CL_OPTION_CODEC};
 
 public:
     // Meta
@@ -92,10 +113,19 @@ public:
     virtual ~UntexCommand() = default;
 
 //-Instance Functions------------------------------------------------------------------------------------------------------
+private:
+    Qx::IoOpReport readTex(KTexReader& texReader, int firstMipMap, int mipMapCount) const;
+    UntexCommandError getThreads(int& threads) const;
+    UntexCommandError getCodec(const BlockCodec*& codec, KTex::Header::PixelFormat format) const;
+    UntexCommandError getConverterOptions(FromTexConverter::Options& options, const KTex& tex, bool forceStraight = false) const;
+
 protected:
     virtual QList<const QCommandLineOption*> options() const override;
-    Qx::IoOpReport readTex(KTex& tex, const QString& path) const;
-    UntexCommandError extractImage(QImage& mainImage, const KTex& tex, bool forceStraight = false) const;
+    // By default only the primary image is read; a negative count reads all remaining mip-maps
+    Qx::IoOpReport readTex(KTex& tex, const QString& path, int firstMipMap = 0, int mipMapCount = 1) const;
+    Qx::IoOpReport readTex(KTex& tex, const QByteArray& data, int firstMipMap = 0, int mipMapCount = 1) const;
+    UntexCommandError extractImage(QImage& mainImage, const KTex& tex, bool forceStraight = false, const QList<QRect>& regions = {}) const;
+    UntexCommandError extractImages(QList<QImage>& images, const KTex& tex) const;
     UntexCommandError writeImage(const QImage& image, const QString& path) const;
 };
 
@@ -1,14 +1,20 @@
 // Unit Includes
 #include "conversion.h"
 
+// Qt Includes
+#include <QThreadPool>
+#include <QMutex>
+#include <QWaitCondition>
+
 // Standard Library Includes
+#include <algorithm>
 #include <cstring>
+#include <atomic>
+#include <future>
+#include <vector>
 
-// Squish Includes
-#include <squish/squish.h>
-
-// etc2comp Includes
-#include <Etc/EtcImage.h>
+// Project Includes
+#include "downsampler.h"
 
 // NOTE: The Qt image formats (QImage::Format) used here are all byte ordered based on the host system, yet squish (and DST?)
 // expect the input data to always be RGB(A), which means these won't work on Big Endian ordered systems;
@@ -19,23 +25,215 @@
 //===============================================================================================================
 namespace
 {
-    int getSquishCompressionFlag(KTex::Header::PixelFormat pixelFormat)
+    // Number of rows of uncompressed pixels converted per task
+    const int PIXEL_BAND_ROWS = 64;
+
+    // Converts one row of 'width' pixels between formats
+    using RowConverter = void(*)(const uchar* source, uchar* target, int width);
+
+    // Same rounding as qPremultiply()
+    uchar premultiply(uint channel, uint alpha)
+    {
+        uint t = channel * alpha;
+        return uchar((t + (t >> 8) + 0x80) >> 8);
+    }
+
+    // In place, with the same rounding as qUnpremultiply(); rows are 'pitch' bytes apart, which may be negative
+    void demultiplyRgbaRows(uchar* rgba, int width, int rows, qsizetype pitch)
     {
-        switch(pixelFormat)
+        for(int y = 0; y < rows; y++, rgba += pitch)
         {
-            case KTex::Header::PixelFormat::DXT5:
-                return squish::kDxt5;
+            // Only alpha being the top byte matters, the other channels are treated the same
+            quint32* px = reinterpret_cast<quint32*>(rgba);
+            for(int x = 0; x < width; x++)
+                px[x] = qUnpremultiply(px[x]);
+        }
+    }
 
-            case KTex::Header::PixelFormat::DXT3:
-                return squish::kDxt3;
+    void copyRgbaRow(const uchar* source, uchar* target, int width) { std::memcpy(target, source, width * 4); }
+    void copyRgbRow(const uchar* source, uchar* target, int width) { std::memcpy(target, source, width * 3); }
 
-            case KTex::Header::PixelFormat::DXT1:
-                return squish::kDxt1;
+    void premultiplyRgbaRow(const uchar* source, uchar* target, int width)
+    {
+        for(int x = 0; x < width; x++, source += 4, target += 4)
+        {
+            uint a = source[3];
+            target[0] = premultiply(source[0], a);
+            target[1] = premultiply(source[1], a);
+            target[2] = premultiply(source[2], a);
+            target[3] = uchar(a);
+        }
+    }
+
+    void opaqueRgbaRow(const uchar* source, uchar* target, int width)
+    {
+        for(int x = 0; x < width; x++, source += 4, target += 4)
+        {
+            std::memcpy(target, source, 3);
+            target[3] = 0xFF;
+        }
+    }
+
+    void rgbToRgbaRow(const uchar* source, uchar* target, int width)
+    {
+        for(int x = 0; x < width; x++, source += 3, target += 4)
+        {
+            std::memcpy(target, source, 3);
+            target[3] = 0xFF;
+        }
+    }
+
+    // The 32-bit formats are stored as host ordered 0xAARRGGBB words
+    void argbToRgbaRow(const uchar* source, uchar* target, int width)
+    {
+        const QRgb* px = reinterpret_cast<const QRgb*>(source);
+        for(int x = 0; x < width; x++, target += 4)
+        {
+            target[0] = qRed(px[x]);
+            target[1] = qGreen(px[x]);
+            target[2] = qBlue(px[x]);
+            target[3] = qAlpha(px[x]);
+        }
+    }
+
+    void argbToPremultipliedRgbaRow(const uchar* source, uchar* target, int width)
+    {
+        const QRgb* px = reinterpret_cast<const QRgb*>(source);
+        for(int x = 0; x < width; x++, target += 4)
+        {
+            uint a = qAlpha(px[x]);
+            target[0] = premultiply(qRed(px[x]), a);
+            target[1] = premultiply(qGreen(px[x]), a);
+            target[2] = premultiply(qBlue(px[x]), a);
+            target[3] = uchar(a);
+        }
+    }
+
+    void xrgbToRgbaRow(const uchar* source, uchar* target, int width)
+    {
+        const QRgb* px = reinterpret_cast<const QRgb*>(source);
+        for(int x = 0; x < width; x++, target += 4)
+        {
+            target[0] = qRed(px[x]);
+            target[1] = qGreen(px[x]);
+            target[2] = qBlue(px[x]);
+            target[3] = 0xFF;
+        }
+    }
+
+    void xrgbToRgbRow(const uchar* source, uchar* target, int width)
+    {
+        const QRgb* px = reinterpret_cast<const QRgb*>(source);
+        for(int x = 0; x < width; x++, target += 3)
+        {
+            target[0] = qRed(px[x]);
+            target[1] = qGreen(px[x]);
+            target[2] = qBlue(px[x]);
+        }
+    }
+
+    // Conversions for the common source formats, others are left to Qt
+    RowConverter rowConverter(QImage::Format source, QImage::Format target)
+    {
+        switch(target)
+        {
+            case QImage::Format_RGBA8888:
+                switch(source)
+                {
+                    case QImage::Format_RGBA8888: return copyRgbaRow;
+                    case QImage::Format_RGBX8888: return opaqueRgbaRow;
+                    case QImage::Format_RGB888: return rgbToRgbaRow;
+                    case QImage::Format_ARGB32: return argbToRgbaRow;
+                    case QImage::Format_RGB32: return xrgbToRgbaRow;
+                    default: return nullptr;
+                }
+
+            case QImage::Format_RGBA8888_Premultiplied:
+                switch(source)
+                {
+                    case QImage::Format_RGBA8888_Premultiplied: return copyRgbaRow;
+                    case QImage::Format_RGBA8888: return premultiplyRgbaRow;
+                    case QImage::Format_RGBX8888: return opaqueRgbaRow;
+                    case QImage::Format_RGB888: return rgbToRgbaRow;
+                    case QImage::Format_ARGB32: return argbToPremultipliedRgbaRow;
+                    case QImage::Format_ARGB32_Premultiplied: return argbToRgbaRow; // Only reorders
+                    case QImage::Format_RGB32: return xrgbToRgbaRow;
+                    default: return nullptr;
+                }
+
+            case QImage::Format_RGB888:
+                switch(source)
+                {
+                    case QImage::Format_RGB888: return copyRgbRow;
+                    case QImage::Format_RGB32: return xrgbToRgbRow;
+                    default: return nullptr;
+                }
 
             default:
-                return -1; // Should never occur
+                return nullptr;
         }
     }
+
+    // Set on the threads of the converters' pools, which never run anything else
+    thread_local bool tPoolThread = false;
+
+    void startOnPool(QThreadPool* pool, const std::function<void()>& task)
+    {
+        pool->start([task]{
+            tPoolThread = true;
+            task();
+        });
+    }
+
+    /* Runs work(i) for every i in [0, count) across the given thread pool and returns once all have finished.
+     *
+     * A pool thread calling this takes part as well, only ever waiting on work that has already started, so nesting
+     * can't deadlock. Any other thread only waits, so that the pool's thread count is the limit on busy threads.
+     */
+    void parallelFor(QThreadPool* pool, int count, const std::function<void(int i)>& work)
+    {
+        if(count <= 0)
+            return;
+
+        struct Job
+        {
+            int count;
+            std::function<void(int i)> work;
+            std::atomic<int> next = 0;
+            std::atomic<int> done = 0;
+            QMutex mutex;
+            QWaitCondition finished;
+        };
+
+        auto job = std::make_shared<Job>();
+        job->count = count;
+        job->work = work;
+
+        // Helpers that only get to run after everything is done exit without touching the work
+        auto run = [job]{
+            for(int i = job->next++; i < job->count; i = job->next++)
+            {
+                job->work(i);
+                if(++job->done == job->count)
+                {
+                    QMutexLocker locker(&job->mutex);
+                    job->finished.wakeAll();
+                }
+            }
+        };
+
+        bool participate = tPoolThread;
+        int helpers = std::min(count, std::max(pool->maxThreadCount(), 1)) - (participate ? 1 : 0);
+        for(int h = 0; h < helpers; h++)
+            startOnPool(pool, run);
+
+        if(participate)
+            run();
+
+        QMutexLocker locker(&job->mutex);
+        while(job->done < count)
+            job->finished.wait(&job->mutex);
+    }
 }
 
 //===============================================================================================================
@@ -46,160 +244,215 @@ namespace
 ToTexConverter::ToTexConverter(const QImage& sourceImage, const Options& options) :
     mSourceImage(sourceImage),
     mOptions(options)
-{}
+{
+    if(mOptions.threads > 0)
+        mPool.setMaxThreadCount(mOptions.threads);
+}
 
 //-Instance Functions--------------------------------------------------------------------------------------------
 //Private:
-QImage ToTexConverter::convertToBasePixelFormat()
+QImage::Format ToTexConverter::basePixelFormat() const
 {
-    QImage::Format newFormat;
-
     if(mOptions.pixelFormat == KTex::Header::PixelFormat::RGB)
-        newFormat = QImage::Format_RGB888;
+        return QImage::Format_RGB888;
     else // The S3TC formats need an RGBA input for compression as well
+        return mOptions.premultiplyAlpha ? QImage::Format_RGBA8888_Premultiplied : QImage::Format_RGBA8888;
+}
+
+QImage ToTexConverter::prepareBaseImage(QByteArray& data)
+{
+    /* Convert, premultiply and flip in a single pass straight into 'data', which the returned image views.
+     * This is laid out exactly as the uncompressed pixel formats are stored, so it can also serve as the base
+     * mip-map's data as is.
+     */
+    QImage::Format format = basePixelFormat();
+    RowConverter converter = rowConverter(mSourceImage.format(), format);
+    if(!converter)
     {
-        if(mOptions.premultiplyAlpha)
-            newFormat = QImage::Format_RGBA8888_Premultiplied;
-        else
-            newFormat = QImage::Format_RGBA8888;
+        QImage image = mSourceImage.convertToFormat(format);
+        image.mirror(); // .flip() in >= Qt 6.9.0
+        return image;
     }
 
-    return mSourceImage.convertToFormat(newFormat);
+    int width = mSourceImage.width();
+    int height = mSourceImage.height();
+    int rowSize = width * (format == QImage::Format_RGB888 ? 3 : 4);
+    qsizetype pitch = ((rowSize + 3) / 4) * 4; // QImage rows are 32-bit aligned
+    data = QByteArray(pitch * height, Qt::Uninitialized);
+    uchar* bits = reinterpret_cast<uchar*>(data.data());
+
+    int bands = (height + PIXEL_BAND_ROWS - 1) / PIXEL_BAND_ROWS;
+    parallelFor(&mPool, bands, [&](int band){
+        int end = std::min(height, (band + 1) * PIXEL_BAND_ROWS);
+        for(int y = band * PIXEL_BAND_ROWS; y < end; y++)
+        {
+            uchar* row = bits + y * pitch;
+            converter(mSourceImage.constScanLine(height - 1 - y), row, width);
+            std::memset(row + rowSize, 0, pitch - rowSize);
+        }
+    });
+
+    return QImage(bits, width, height, pitch, format);
 }
 
-QVector<QImage> ToTexConverter::generateMipMaps(const QImage& baseImage)
+QList<QSize> ToTexConverter::mipMapSizes() const
 {
-    // Ideally this would perform a bit more image processing but Qt doesn't have much
-    // and for now the priority is to keep lib dependency low (ImageMagick feature disabling
-    // on Windows in particular is really troublesome and it has a conflict with harfbuzz in Qt)
+    QList<QSize> sizes;
+    QSize mipMapSize = mSourceImage.size();
+    sizes.append(mipMapSize);
 
-    QVector<QImage> mipMaps;
-    QSize mipMapSize = baseImage.size();
-
-    while(mipMapSize != QSize(1,1))
+    if(mOptions.generateMipMaps)
     {
-        mipMapSize /= 2; // This always rounds up to the nearest integer, so it won't drop the dimensions below 1x1
-        mipMaps.append(baseImage.scaled(mipMapSize, Qt::IgnoreAspectRatio, Qt::SmoothTransformation));
+        while(mipMapSize != QSize(1,1))
+        {
+            mipMapSize /= 2; // This always rounds up to the nearest integer, so it won't drop the dimensions below 1x1
+            sizes.append(mipMapSize);
+        }
     }
 
-    return mipMaps;
+    return sizes;
 }
 
-QVector<KTex::MipMapImage> ToTexConverter::convertToTargetFormat(const QVector<QImage>& images)
+QImage ToTexConverter::generateMipMap(const QImage& previousLevel, const QSize& size)
 {
-    auto pxFormat = mOptions.pixelFormat;
-    QVector<KTex::MipMapImage> outputImages;
+    // A dedicated box filter, since QImage::scaled() is generic and converts formats/allocates on every call
+    Downsampler downsampler(previousLevel, size, mOptions.srgbMipMaps);
 
-    for(const QImage& image : images)
-    {
-        KTex::MipMapImage mipMap;
+    // Rows are independent, so bands of them can be filtered concurrently straight into place
+    int bands = (size.height() + PIXEL_BAND_ROWS - 1) / PIXEL_BAND_ROWS;
+    parallelFor(&mPool, bands, [&](int band){
+        int firstRow = band * PIXEL_BAND_ROWS;
+        downsampler.downsampleRows(firstRow, std::min(PIXEL_BAND_ROWS, size.height() - firstRow));
+    });
 
-        // Common steps
-        mipMap.setWidth(image.width());
-        mipMap.setHeight(image.height());
+    return downsampler.target();
+}
 
-        // Encoder specific steps
-        switch(pxFormat) // Use variants, inheritance, or other functions for this if many more types are added
-        {
-            using enum KTex::Header::PixelFormat;
+KTex::MipMapImage ToTexConverter::convertToTargetFormat(const QImage& image, const QByteArray& data)
+{
+    auto pxFormat = mOptions.pixelFormat;
+    KTex::MipMapImage mipMap;
 
-            case RGB:
-            case RGBA:
-                mipMap.setPitch(image.bytesPerLine());
-                mipMap.setImageDataSize(image.sizeInBytes());
-                std::memcpy(mipMap.imageData().data(), image.bits(), image.sizeInBytes());
-                break;
+    // Common steps
+    mipMap.setWidth(image.width());
+    mipMap.setHeight(image.height());
 
-            case DXT1:
-            case DXT3:
-            case DXT5:
+    // Encoder specific steps
+    switch(pxFormat)
+    {
+        using enum KTex::Header::PixelFormat;
+
+        case RGB:
+        case RGBA:
+            mipMap.setPitch(image.bytesPerLine());
+            if(!data.isNull()) // Already holds the image as stored
+                mipMap.imageData() = data;
+            else
             {
-                int squishFlag = getSquishCompressionFlag(pxFormat);
-                mipMap.setPitch(squish::GetStorageRequirements(image.width(), 1, squishFlag)); // Space for one row of blocks
-                mipMap.setImageDataSize(squish::GetStorageRequirements(image.width(), image.height(), squishFlag));
-                squish::CompressImage(image.bits(), image.width(), image.height(), image.bytesPerLine(),
-                                      mipMap.imageData().data(), squishFlag);
+                mipMap.setImageDataSize(image.sizeInBytes());
+                std::memcpy(mipMap.imageData().data(), image.bits(), image.sizeInBytes());
             }
+            break;
 
-            case ETC2EAC:
+        default:
+        {
+            const BlockCodec* codec = mOptions.codec ? mOptions.codec : BlockCodec::preferredEncoder(pxFormat);
+            if(!codec || !codec->encodes(pxFormat))
             {
-                /* The pitch calculation below boils down to:
-                 *     p = blocks_per_row * block_size
-                 *     where
-                 *     block_size varies with format
-                 *     blocks_per_row = ceil(width/4)
-                 */
-
-                // Get texture info
-                auto etcFormat = Etc::Image::Format::RGBA8; // Make function for this, like for squish, if more ETC formats are supported
-
-                // Create ETC image
-                auto errMetric = image.isGrayscale() ? Etc::ErrorMetric::GRAY : Etc::ErrorMetric::NUMERIC; // Could try the Rec 709 option for color
-                /* The standard allows viewing a POD struct as a sequence of bytes (e.g. auto data = reinterpret_cast<uchar*>(myStruct)),
-                 * but does not allow the other way around; however, in the case of a very simple struct of ints, almost no known compiler
-                 * inserts padding between the members, so here we're gonna try what is technically UB, casting an array to a struct, since
-                 * it generally works and this application is non-critical. This is possible because each struct member is exactly 1-byte in
-                 * size and is laid out in the correct R-G-B-A order.
-                 *
-                 * This lib has a really strange interface, as it was hacked together by someone else after its initial creation.
-                 * You make an image with uncompressed pixel data, despite the type (Etc::Image) being named like you already have
-                 * a compressed image, and then call Encode.
-                 */
-                Etc::Image etcImage(etcFormat, (const Etc::ColorR8G8B8A8*)image.bits(), image.width(), image.height(), errMetric);
-
-                // Prepare mip-map
-                mipMap.setPitch(etcImage.GetNumberOfBlockColumns() * etcImage.GetBlockSize()); // Space for one row of blocks
-                mipMap.setImageDataSize(etcImage.GetEncodingBitsBytes());
-
-                // Encode
-                constexpr float quality = 90; /* (0-100) could add flag to allow adjusting, but awkward since its just for this format, though we could just
-                                               * say "for formats where it applies" and for now it's only this one. Kram uses 49 by default and states that
-                                               * unity uses "80".
-                                               */
-                auto status = etcImage.EncodeSinglepass(quality, reinterpret_cast<uchar*>(mipMap.imageData().data()));
-                if(status != Etc::Image::SUCCESS)
-                    qWarning("Unexpected ETC2 encode error: 0x%x", status);
+                qCritical("Unhandled encoding pixel format!");
                 break;
             }
 
-            default:
-                qCritical("Unhandled encoding pixel format!");
+            int blockRowSize = KTex::standardPitch(pxFormat, image.width());
+            mipMap.setPitch(blockRowSize); // Space for one row of blocks
+            mipMap.setImageDataSize(KTex::standardImageDataSize(pxFormat, image.width(), image.height()));
+
+            // Decided once for the level, since a band being gray doesn't mean the image is
+            bool grayscale = image.isGrayscale();
+
+            // Blocks are independent, so bands of block rows can be encoded concurrently straight into place
+            uchar* blocks = reinterpret_cast<uchar*>(mipMap.imageData().data());
+            int bandRows = codec->bandBlockRows();
+            int blockRows = (image.height() + 3) / 4;
+            int bands = (blockRows + bandRows - 1) / bandRows;
+            parallelFor(&mPool, bands, [&](int band){
+                int firstRow = band * bandRows * 4;
+                int rows = std::min(bandRows * 4, image.height() - firstRow);
+                codec->encode(image.constScanLine(firstRow), image.width(), rows, image.bytesPerLine(),
+                              blocks + band * bandRows * blockRowSize, pxFormat, mOptions.quality, grayscale);
+            });
+            break;
         }
-
-        outputImages.append(mipMap);
     }
 
-    return outputImages;
+    return mipMap;
 }
 
 //Public:
-KTex ToTexConverter::convert()
+KTex::Info ToTexConverter::metadata() const
 {
-    // Convert to base pixel format to work with
-    QImage baseImage = convertToBasePixelFormat();
+    KTex::Header header;
+    header.setTextureType(mOptions.textureType);
+    header.setPixelFormat(mOptions.pixelFormat);
 
-    // Flip
-    baseImage.mirror(); // .flip() in >= Qt 6.9.0
+    return KTex::expectedMetadata(header, mipMapSizes());
+}
 
-    // Working images
-    QVector<QImage> workingImages = {baseImage};
+bool ToTexConverter::convert(const MipMapSink& sink)
+{
+    // Convert to base pixel format to work with, and flip; the image may view the data, which must outlive it
+    QByteArray baseData;
+    QImage baseImage = prepareBaseImage(baseData);
+
+    /* Each level is generated from the one before it, which together costs about a third of the base image
+     * rather than a full resample of it per level. Levels are encoded concurrently as soon as they're generated,
+     * so that the smaller ones fill in around the largest, and each is handed off in order as soon as it and
+     * those before it are done.
+     */
+    const QList<QSize> sizes = mipMapSizes();
+    std::vector<std::future<KTex::MipMapImage>> levels;
+    levels.reserve(sizes.size());
+
+    QImage levelImage = baseImage;
+    for(qsizetype i = 0; i < sizes.size(); i++)
+    {
+        QByteArray levelData = i == 0 ? baseData : QByteArray();
+        if(i > 0)
+            levelImage = generateMipMap(levelImage, sizes.at(i));
+
+        // The promise is shared since pool tasks must be copyable, the image is implicitly shared
+        auto promise = std::make_shared<std::promise<KTex::MipMapImage>>();
+        levels.push_back(promise->get_future());
+        startOnPool(&mPool, [this, promise, levelImage, levelData]{
+            promise->set_value(convertToTargetFormat(levelImage, levelData));
+        });
+    }
 
-    // Generate mipmaps
-    if(mOptions.generateMipMaps)
-        workingImages = workingImages + generateMipMaps(baseImage);
+    // Every level has to finish before returning since they all use the converter and base data, even if the sink stops early
+    bool accepted = true;
+    for(std::future<KTex::MipMapImage>& level : levels)
+    {
+        KTex::MipMapImage mipMap = level.get();
+        if(accepted)
+            accepted = sink(std::move(mipMap));
+    }
 
-    // Convert to KTex image/mipmap format
-    QVector<KTex::MipMapImage> outputImages = convertToTargetFormat(workingImages);
+    return accepted;
+}
 
+KTex ToTexConverter::convert()
+{
     // Create KTex
     KTex tex;
 
     // Set header specs
-    tex.header().setTextureType(mOptions.textureType);
-    tex.header().setPixelFormat(mOptions.pixelFormat);
+    tex.header() = metadata().header;
 
-    // Set imags
-    tex.mipMaps().swap(outputImages);
+    // Collect images
+    convert([&tex](KTex::MipMapImage&& mipMap){
+        tex.mipMaps().append(std::move(mipMap));
+        return true;
+    });
 
     // Return finished tex
     return tex;
@@ -213,90 +466,164 @@ KTex ToTexConverter::convert()
 FromTexConverter::FromTexConverter(const KTex& sourceTex, const Options& options) :
     mSourceTex(sourceTex),
     mOptions(options)
-{}
+{
+    if(mOptions.threads > 0)
+        mPool.setMaxThreadCount(mOptions.threads);
+}
 
 //-Instance Functions--------------------------------------------------------------------------------------------
 //Private:
 const KTex::MipMapImage& FromTexConverter::getMainImage() { return mSourceTex.mipMaps().at(0); } //TODO: Check if mipmap actually exists
 
-QImage FromTexConverter::convertToStandardFormat(const KTex::MipMapImage& mainImage)
+void FromTexConverter::decodeRegions(const BlockCodec* codec, const KTex::MipMapImage& image, const QList<QRect>& regions,
+                                     uchar* pixels, int pitch)
 {
-    QByteArray decodedData;
-    quint16 decodedPitch{};
-    QImage::Format decodedFormat{};
+    auto pxFormat = mSourceTex.header().pixelFormat();
+    int blockRowSize = KTex::standardPitch(pxFormat, image.width());
+    int blockSize = KTex::standardPitch(pxFormat, 4);
+    int blockColumns = (image.width() + 3) / 4;
+    int blockRows = (image.height() + 3) / 4;
+
+    // Mark the blocks the regions touch, noting that the regions are in terms of the flipped image
+    QList<bool> needed(blockColumns * blockRows, false);
+    QRect bounds(0, 0, image.width(), image.height());
+    for(const QRect& region : regions)
+    {
+        QRect clipped = region.intersected(bounds);
+        if(clipped.isEmpty())
+            continue;
+
+        int firstRow = (image.height() - 1 - clipped.bottom()) / 4;
+        int lastRow = (image.height() - 1 - clipped.top()) / 4;
+        for(int by = firstRow; by <= lastRow; by++)
+            std::fill_n(needed.begin() + by * blockColumns + clipped.left() / 4, clipped.right() / 4 - clipped.left() / 4 + 1, true);
+    }
+
+    // Decode each run of needed blocks within a row as one narrower image
+    parallelFor(&mPool, blockRows, [&](int by){
+        const bool* row = needed.constData() + by * blockColumns;
+        int y = by * 4;
+        for(int bx = 0; bx < blockColumns;)
+        {
+            if(!row[bx])
+            {
+                bx++;
+                continue;
+            }
+
+            int runStart = bx;
+            while(bx < blockColumns && row[bx])
+                bx++;
+
+            int x = runStart * 4;
+            int runWidth = std::min(bx * 4, int(image.width())) - x;
+            int runHeight = std::min(4, image.height() - y);
+            uchar* runPixels = pixels + y * pitch + x * 4;
+            codec->decode(reinterpret_cast<const uchar*>(image.imageData().constData()) + by * blockRowSize + runStart * blockSize,
+                          runWidth, runHeight, runPixels, pitch, pxFormat);
 
+            if(mOptions.demultiplyAlpha)
+                demultiplyRgbaRows(runPixels, runWidth, runHeight, pitch);
+        }
+    });
+}
+
+QImage FromTexConverter::convertToStandardFormat(const KTex::MipMapImage& mipMap, const QList<QRect>& regions)
+{
+    /* Pixels are written once, straight into the final image. TEX images are stored upside down, so rows are
+     * written from the bottom up, and alpha is demultiplied band by band while each is still in cache.
+     */
     auto pxFormat = mSourceTex.header().pixelFormat();
-    switch(pxFormat) // Use variants, inheritance, or other functions for this if many more types are added
+    int width = mipMap.width();
+    int height = mipMap.height();
+    const uchar* data = reinterpret_cast<const uchar*>(mipMap.imageData().constData());
+    bool demultiply = mOptions.demultiplyAlpha && pxFormat != KTex::Header::PixelFormat::RGB;
+
+    QImage image(width, height, pxFormat == KTex::Header::PixelFormat::RGB ? QImage::Format_RGB888 : QImage::Format_RGBA8888);
+    if(image.isNull())
+        return image;
+
+    int pitch = -image.bytesPerLine();
+    uchar* pixels = image.scanLine(height - 1);
+
+    switch(pxFormat)
     {
         using enum KTex::Header::PixelFormat;
 
         case RGB:
-            decodedFormat = QImage::Format_RGB888;
-            decodedPitch = mainImage.pitch();
-            decodedData = mainImage.imageData(); // Implicit sharing avoids copy
-            break;
-
         case RGBA:
-            decodedFormat = mOptions.demultiplyAlpha ? QImage::Format_RGBA8888_Premultiplied : QImage::Format_RGBA8888;
-            decodedPitch = mainImage.pitch();
-            decodedData = mainImage.imageData(); // Implicit sharing avoids copy
-            break;
-
-        case DXT1:
-        case DXT3:
-        case DXT5:
         {
-            decodedFormat = mOptions.demultiplyAlpha ? QImage::Format_RGBA8888_Premultiplied : QImage::Format_RGBA8888;
-            decodedPitch = mainImage.width() * 4;
-            int squishFlag = getSquishCompressionFlag(pxFormat);
-            decodedData.resize(mainImage.width() * mainImage.height() * 4);
-            squish::DecompressImage(reinterpret_cast<uchar*>(decodedData.data()), mainImage.width(), mainImage.height(), decodedPitch,
-                                    mainImage.imageData().data(), squishFlag);
+            int rowSize = width * (pxFormat == RGB ? 3 : 4);
+            int bands = (height + PIXEL_BAND_ROWS - 1) / PIXEL_BAND_ROWS;
+            parallelFor(&mPool, bands, [&](int band){
+                int firstRow = band * PIXEL_BAND_ROWS;
+                int rows = std::min(PIXEL_BAND_ROWS, height - firstRow);
+                for(int y = firstRow; y < firstRow + rows; y++)
+                    std::memcpy(pixels + y * pitch, data + y * mipMap.pitch(), rowSize);
+
+                if(demultiply)
+                    demultiplyRgbaRows(pixels + firstRow * pitch, width, rows, pitch);
+            });
             break;
         }
 
-        case ETC2EAC:
+        default:
         {
-            decodedFormat = mOptions.demultiplyAlpha ? QImage::Format_RGBA8888_Premultiplied : QImage::Format_RGBA8888;
-            decodedPitch = mainImage.width() * 4;
-            auto etcFormat = Etc::Image::Format::RGBA8; // Make function for this, like for squish, if more ETC formats are supported
-            decodedData.resize(mainImage.width() * mainImage.height() * 4);
-            /* This lib has a really strange interface, as it was hacked together by someone else after its initial creation.
-             * You make an image with no pixel data set and then pass the pixel data as part of the Encode call
-             */
-            Etc::Image etcImage(etcFormat, nullptr, 1024, 1024, Etc::ErrorMetric::NUMERIC);
-            auto status = etcImage.Decode(reinterpret_cast<const uchar*>(mainImage.imageData().data()),
-                                          reinterpret_cast<uchar*>(decodedData.data()));
-            if(status != Etc::Image::SUCCESS)
-                qWarning("Unexpected ETC2 decode error: 0x%x", status);
+            const BlockCodec* codec = mOptions.codec ? mOptions.codec : BlockCodec::preferredDecoder(pxFormat);
+            if(!codec || !codec->decodes(pxFormat))
+            {
+                qCritical("Unhandled decoding pixel format!");
+                return QImage();
+            }
+
+            if(!regions.isEmpty())
+            {
+                // Everything outside of the regions is left transparent
+                image.fill(Qt::transparent);
+                decodeRegions(codec, mipMap, regions, pixels, pitch);
+                break;
+            }
+
+            // Blocks are independent, so bands of block rows can be decoded concurrently straight into place
+            int blockRowSize = KTex::standardPitch(pxFormat, width);
+            int bandRows = codec->bandBlockRows();
+            int blockRows = (height + 3) / 4;
+            int bands = (blockRows + bandRows - 1) / bandRows;
+            parallelFor(&mPool, bands, [&](int band){
+                int firstRow = band * bandRows * 4;
+                int rows = std::min(bandRows * 4, height - firstRow);
+                uchar* bandPixels = pixels + firstRow * pitch;
+                codec->decode(data + band * bandRows * blockRowSize, width, rows, bandPixels, pitch, pxFormat);
+
+                if(demultiply)
+                    demultiplyRgbaRows(bandPixels, width, rows, pitch);
+            });
             break;
         }
-
-        default:
-            qCritical("Unhandled decoding pixel format!");
     }
 
-    // Create QImage from buffer
-    QImage bufferedImage = QImage(reinterpret_cast<uchar*>(decodedData.data()), mainImage.width(), mainImage.height(), decodedPitch, decodedFormat);
-
-    // Copy and detach image so it isn't reliant on buffer that will be destroyed
-    QImage standaloneImage = bufferedImage.copy();
-    standaloneImage.detach();
-
-    return standaloneImage;
+    return image;
 }
 
 //Public:
-QImage FromTexConverter::convert()
+QImage FromTexConverter::convert(const QList<QRect>& regions)
 {
     // Get primariy image
-    const KTex::MipMapImage& mainImage = getMainImage();
-
-    // Convert to QImage
-    QImage img = convertToStandardFormat(mainImage);
-
-    // Flip
-    img.mirror(); // .flip() in >= Qt 6.9.0
+    return convertToStandardFormat(getMainImage(), regions);
+}
 
-    return img;
+QList<QImage> FromTexConverter::convertAll()
+{
+    /* Levels are decoded concurrently, each spreading its own bands over the same pool, so the smaller levels
+     * fill in around the largest one instead of trailing after it
+     */
+    const QVector<KTex::MipMapImage>& mipMaps = mSourceTex.mipMaps();
+    QList<QImage> images(mipMaps.size());
+    QImage* levels = images.data();
+
+    parallelFor(&mPool, mipMaps.size(), [&](int i){
+        levels[i] = convertToStandardFormat(mipMaps.at(i), {});
+    });
+
+    return images;
 }
@@ -3,12 +3,21 @@
 
 // Qt Includes
 #include <QImage>
+#include <QThreadPool>
+
+// Standard Library Includes
+#include <functional>
 
 // Project Includes
 #include "klei/k-tex.h"
+#include "codec/block-codec.h"
 
 class ToTexConverter
 {
+//-Aliases----------------------------------------------------------------------------------------------------------
+public:
+    using Quality = BlockCodec::Quality;
+
 //-Structs----------------------------------------------------------------------------------------------------------
 public:
     struct Options
@@ -17,9 +26,16 @@ public:
         KTex::Header::TextureType textureType = KTex::Header::TextureType::TwoD;
         KTex::Header::PixelFormat pixelFormat = KTex::Header::PixelFormat::DXT5;
         bool generateMipMaps = true;
+        bool srgbMipMaps = false; // Downsample color in linear light, treating it as sRGB
         bool premultiplyAlpha = true;
+        Quality quality = Quality::Normal; // Trades encoding speed for accuracy in the block compressed formats
+        const BlockCodec* codec = nullptr; // The preferred codec for the pixel format is used if not set
+        int threads = 0; // 0 uses all available
     };
 
+    // Receives each encoded mip-map in order, returning false stops conversion
+    using MipMapSink = std::function<bool(KTex::MipMapImage&& mipMap)>;
+
 //-Class Members----------------------------------------------------------------------------------------------------
 private:
 
@@ -27,6 +43,7 @@ private:
 private:
     const QImage& mSourceImage;
     const Options& mOptions;
+    QThreadPool mPool;
 
 //-Constructor-------------------------------------------------------------------------------------------------------
 public:
@@ -34,11 +51,15 @@ public:
 
 //-Instance Functions----------------------------------------------------------------------------------------------
 private:
-    QImage convertToBasePixelFormat();
-    QVector<QImage> generateMipMaps(const QImage& baseImage);
-    QVector<KTex::MipMapImage> convertToTargetFormat(const QVector<QImage>& images);
+    QImage::Format basePixelFormat() const;
+    QImage prepareBaseImage(QByteArray& data);
+    QList<QSize> mipMapSizes() const;
+    QImage generateMipMap(const QImage& previousLevel, const QSize& size);
+    KTex::MipMapImage convertToTargetFormat(const QImage& image, const QByteArray& data = {});
 
 public:
+    KTex::Info metadata() const;
+    bool convert(const MipMapSink& sink);
     KTex convert();
 };
 
@@ -49,12 +70,15 @@ public:
     struct Options
     {
         bool demultiplyAlpha = true;
+        const BlockCodec* codec = nullptr; // The preferred codec for the pixel format is used if not set
+        int threads = 0; // 0 uses all available
     };
 
 //-Instance Members-------------------------------------------------------------------------------------------------
 private:
     const KTex& mSourceTex;
     const Options& mOptions;
+    QThreadPool mPool;
 
 //-Constructor-------------------------------------------------------------------------------------------------------
 public:
@@ -63,10 +87,13 @@ public:
 //-Instance Functions----------------------------------------------------------------------------------------------
 private:
     const KTex::MipMapImage& getMainImage();
-    QImage convertToStandardFormat(const KTex::MipMapImage& mainImage);
+    void decodeRegions(const BlockCodec* codec, const KTex::MipMapImage& image, const QList<QRect>& regions, uchar* pixels, int pitch);
+    QImage convertToStandardFormat(const KTex::MipMapImage& mipMap, const QList<QRect>& regions);
 
 public:
-    QImage convert();
+    // If regions are given, only the blocks covering those areas of the result are decoded where possible
+    QImage convert(const QList<QRect>& regions = {});
+    QList<QImage> convertAll(); // Every mip-map, in order
 };
 
 #endif // CONVERSION_H
@@ -0,0 +1,345 @@
+// Unit Includes
+#include "downsampler.h"
+
+// Standard Library Includes
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+// Project Includes
+#include "codec/cpu-features.h"
+
+// SIMD Includes
+#ifdef STEX_SSE2
+    #include <emmintrin.h>
+#endif
+
+//===============================================================================================================
+// UNIT ONLY
+//===============================================================================================================
+namespace
+{
+    // sRGB transfer, with the encoding side quantized finely enough to round trip every 8-bit value
+    const int LINEAR_TO_SRGB_STEPS = 4096;
+
+    const std::array<float, 256>& srgbToLinear()
+    {
+        static const std::array<float, 256> lut = []{
+            std::array<float, 256> table;
+            for(int i = 0; i < 256; i++)
+            {
+                double c = i / 255.0;
+                table[i] = float(c <= 0.04045 ? c / 12.92 : std::pow((c + 0.055) / 1.055, 2.4));
+            }
+            return table;
+        }();
+
+        return lut;
+    }
+
+    const std::array<uchar, LINEAR_TO_SRGB_STEPS>& linearToSrgb()
+    {
+        static const std::array<uchar, LINEAR_TO_SRGB_STEPS> lut = []{
+            std::array<uchar, LINEAR_TO_SRGB_STEPS> table;
+            for(int i = 0; i < LINEAR_TO_SRGB_STEPS; i++)
+            {
+                double l = double(i) / (LINEAR_TO_SRGB_STEPS - 1);
+                double c = l <= 0.0031308 ? l * 12.92 : 1.055 * std::pow(l, 1.0 / 2.4) - 0.055;
+                table[i] = uchar(std::lround(std::clamp(c, 0.0, 1.0) * 255));
+            }
+            return table;
+        }();
+
+        return lut;
+    }
+
+    // Premultiplied value to straight, rounded to nearest, indexed by alpha * 256 + value
+    const std::array<uchar, 256 * 256>& unpremultiplyTable()
+    {
+        static const std::array<uchar, 256 * 256> lut = []{
+            std::array<uchar, 256 * 256> table;
+            for(int a = 0; a < 256; a++)
+                for(int v = 0; v < 256; v++)
+                    table[a * 256 + v] = a ? uchar(std::min(255, (v * 255 + a / 2) / a)) : 0;
+            return table;
+        }();
+
+        return lut;
+    }
+
+    // Rounds half away from zero like std::lround() for the values that matter (>= -0.5), without the library call
+    int roundToInt(float value) { return int(value + 0.5f); }
+    uchar toByte(float value) { return uchar(std::clamp(roundToInt(value), 0, 255)); }
+
+    void halveRgbaRow(const uchar* top, const uchar* bottom, uchar* out, int targetWidth)
+    {
+        int x = 0;
+#ifdef STEX_SSE2
+        // Four source pixels from each row make two target pixels
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i rounding = _mm_set1_epi16(2);
+        for(; x + 2 <= targetWidth; x += 2)
+        {
+            __m128i t = _mm_loadu_si128(reinterpret_cast<const __m128i*>(top + x * 8));
+            __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bottom + x * 8));
+
+            // Vertical sums at 16-bit for pixels 0-1 and 2-3, then add each horizontal pair
+            __m128i lo = _mm_add_epi16(_mm_unpacklo_epi8(t, zero), _mm_unpacklo_epi8(b, zero));
+            __m128i hi = _mm_add_epi16(_mm_unpackhi_epi8(t, zero), _mm_unpackhi_epi8(b, zero));
+            __m128i sums = _mm_add_epi16(_mm_unpacklo_epi64(lo, hi), _mm_unpackhi_epi64(lo, hi));
+
+            __m128i averages = _mm_srli_epi16(_mm_add_epi16(sums, rounding), 2);
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(out + x * 4), _mm_packus_epi16(averages, zero));
+        }
+#endif
+        for(; x < targetWidth; x++)
+        {
+            const uchar* t = top + x * 8;
+            const uchar* b = bottom + x * 8;
+            for(int c = 0; c < 4; c++)
+                out[x * 4 + c] = uchar((t[c] + t[c + 4] + b[c] + b[c + 4] + 2) >> 2);
+        }
+    }
+
+    void halveRgbRow(const uchar* top, const uchar* bottom, uchar* out, int targetWidth)
+    {
+        for(int x = 0; x < targetWidth; x++)
+        {
+            const uchar* t = top + x * 6;
+            const uchar* b = bottom + x * 6;
+            for(int c = 0; c < 3; c++)
+                out[x * 3 + c] = uchar((t[c] + t[c + 3] + b[c] + b[c + 3] + 2) >> 2);
+        }
+    }
+
+    void halveStraightRow(const uchar* top, const uchar* bottom, uchar* out, int targetWidth)
+    {
+        // Color is weighted by alpha, which integer math does exactly for a 2x2 square
+        for(int x = 0; x < targetWidth; x++, out += 4)
+        {
+            const uchar* px[4]{top + x * 8, top + x * 8 + 4, bottom + x * 8, bottom + x * 8 + 4};
+            uint alpha = px[0][3] + px[1][3] + px[2][3] + px[3][3];
+            for(int c = 0; c < 3; c++)
+            {
+                uint color = px[0][c] * px[0][3] + px[1][c] * px[1][3] + px[2][c] * px[2][3] + px[3][c] * px[3][3];
+                out[c] = alpha ? uchar((color + alpha / 2) / alpha) : 0;
+            }
+            out[3] = uchar((alpha + 2) >> 2);
+        }
+    }
+
+    // Weighted sums of source pixels, in the space their color is averaged in
+    struct PixelSum
+    {
+        float color[3]{};
+        float alpha = 0;
+        float weight = 0;
+        float colorWeight = 0;
+    };
+
+    /* Averages in float, for when color has to be weighted by alpha at arbitrary coverage, or converted to linear
+     * light. The combination in use is fixed per image, so it is a template parameter rather than checked per pixel.
+     */
+    template<int Channels, bool Srgb, bool Unpremultiply, bool WeightByAlpha>
+    struct FloatAverage
+    {
+        static const int CHANNELS = Channels;
+
+        const float* toLinear = srgbToLinear().data();
+        const uchar* toSrgb = linearToSrgb().data();
+        const uchar* toStraight = unpremultiplyTable().data();
+
+        void accumulate(PixelSum& sum, const uchar* px, float weight) const
+        {
+            int a = Channels == 4 ? px[3] : 255;
+            float colorWeight = WeightByAlpha ? weight * a * (1 / 255.0f) : weight;
+
+            for(int c = 0; c < 3; c++)
+            {
+                int value = px[c];
+                if constexpr(Unpremultiply)
+                    value = toStraight[a * 256 + value];
+                sum.color[c] += (Srgb ? toLinear[value] : value) * colorWeight;
+            }
+
+            sum.alpha += a * weight;
+            sum.weight += weight;
+            sum.colorWeight += colorWeight;
+        }
+
+        void resolve(const PixelSum& sum, uchar* out) const
+        {
+            float outAlpha = sum.alpha / sum.weight;
+            for(int c = 0; c < 3; c++)
+            {
+                float value = sum.colorWeight > 0 ? sum.color[c] / sum.colorWeight : 0;
+                if constexpr(Srgb)
+                    value = toSrgb[std::clamp(roundToInt(value * (LINEAR_TO_SRGB_STEPS - 1)), 0, LINEAR_TO_SRGB_STEPS - 1)];
+                if constexpr(Unpremultiply)
+                    value = value * toByte(outAlpha) / 255.0f;
+                out[c] = toByte(value);
+            }
+
+            if constexpr(Channels == 4)
+                out[3] = toByte(outAlpha);
+        }
+    };
+}
+
+
+//===============================================================================================================
+// Downsampler
+//===============================================================================================================
+
+//-Constructor-------------------------------------------------------------------------------------------------
+//Public:
+Downsampler::Downsampler(const QImage& source, const QSize& size, bool srgb) :
+    mSource(source),
+    mTarget(size, source.format()),
+    mTargetBits(mTarget.bits())
+{
+    Q_ASSERT(source.format() == QImage::Format_RGB888 || source.format() == QImage::Format_RGBA8888 ||
+             source.format() == QImage::Format_RGBA8888_Premultiplied);
+
+    bool exactHalf = source.width() == size.width() * 2 && source.height() == size.height() * 2;
+    if(!exactHalf)
+    {
+        mXTaps = areaTaps(source.width(), size.width());
+        mYTaps = areaTaps(source.height(), size.height());
+    }
+
+    // Premultiplied color is already weighted by alpha, unless it has to be separated to convert it
+    switch(source.format())
+    {
+        case QImage::Format_RGB888:
+            mRowFunction = exactHalf && !srgb ? &Downsampler::halve :
+                           srgb ? floatRowFunction<FloatAverage<3, true, false, false>>(exactHalf) :
+                                  floatRowFunction<FloatAverage<3, false, false, false>>(exactHalf);
+            break;
+
+        case QImage::Format_RGBA8888_Premultiplied:
+            mRowFunction = exactHalf && !srgb ? &Downsampler::halve :
+                           srgb ? floatRowFunction<FloatAverage<4, true, true, true>>(exactHalf) :
+                                  floatRowFunction<FloatAverage<4, false, false, false>>(exactHalf);
+            break;
+
+        default:
+            mRowFunction = exactHalf && !srgb ? &Downsampler::halveStraight :
+                           srgb ? floatRowFunction<FloatAverage<4, true, false, true>>(exactHalf) :
+                                  floatRowFunction<FloatAverage<4, false, false, true>>(exactHalf);
+            break;
+    }
+}
+
+//-Class Functions----------------------------------------------------------------------------------------------
+//Private:
+std::vector<Downsampler::AxisTaps> Downsampler::areaTaps(int sourceLength, int targetLength)
+{
+    Q_ASSERT(sourceLength <= targetLength * 2);
+
+    std::vector<AxisTaps> taps(targetLength);
+    double scale = double(sourceLength) / targetLength;
+
+    for(int t = 0; t < targetLength; t++)
+    {
+        double start = t * scale;
+        double end = (t + 1) * scale;
+        AxisTaps& axisTaps = taps[t];
+        axisTaps.first = int(start);
+        axisTaps.count = 0;
+
+        for(int s = axisTaps.first; s < sourceLength && s < end; s++)
+        {
+            double covered = std::min<double>(s + 1, end) - std::max<double>(s, start);
+            if(covered <= 0)
+                continue;
+
+            if(axisTaps.count == 0)
+                axisTaps.first = s;
+            Q_ASSERT(axisTaps.count < MAX_TAPS);
+            axisTaps.weights[axisTaps.count++] = float(covered);
+        }
+    }
+
+    return taps;
+}
+
+//-Instance Functions--------------------------------------------------------------------------------------------
+//Private:
+void Downsampler::halve(int y, uchar* out) const
+{
+    const uchar* top = mSource.constScanLine(y * 2);
+    const uchar* bottom = mSource.constScanLine(y * 2 + 1);
+
+    if(mSource.format() == QImage::Format_RGB888)
+        halveRgbRow(top, bottom, out, mTarget.width());
+    else
+        halveRgbaRow(top, bottom, out, mTarget.width());
+}
+
+void Downsampler::halveStraight(int y, uchar* out) const
+{
+    halveStraightRow(mSource.constScanLine(y * 2), mSource.constScanLine(y * 2 + 1), out, mTarget.width());
+}
+
+template<typename Average>
+void Downsampler::halveFloat(int y, uchar* out) const
+{
+    const int channels = Average::CHANNELS;
+    const uchar* top = mSource.constScanLine(y * 2);
+    const uchar* bottom = mSource.constScanLine(y * 2 + 1);
+    Average average;
+
+    // Every pixel of the 2x2 square is fully covered, so there are no taps to look up
+    for(int x = 0; x < mTarget.width(); x++, top += channels * 2, bottom += channels * 2, out += channels)
+    {
+        PixelSum sum;
+        average.accumulate(sum, top, 1);
+        average.accumulate(sum, top + channels, 1);
+        average.accumulate(sum, bottom, 1);
+        average.accumulate(sum, bottom + channels, 1);
+        average.resolve(sum, out);
+    }
+}
+
+template<typename Average>
+void Downsampler::areaAverage(int y, uchar* out) const
+{
+    const int channels = Average::CHANNELS;
+    const AxisTaps& yTaps = mYTaps[y];
+    const uchar* rows[MAX_TAPS];
+    for(int ty = 0; ty < yTaps.count; ty++)
+        rows[ty] = mSource.constScanLine(yTaps.first + ty);
+
+    Average average;
+    for(int x = 0; x < mTarget.width(); x++, out += channels)
+    {
+        const AxisTaps& xTaps = mXTaps[x];
+        PixelSum sum;
+
+        for(int ty = 0; ty < yTaps.count; ty++)
+        {
+            const uchar* px = rows[ty] + xTaps.first * channels;
+            for(int tx = 0; tx < xTaps.count; tx++, px += channels)
+                average.accumulate(sum, px, yTaps.weights[ty] * xTaps.weights[tx]);
+        }
+
+        average.resolve(sum, out);
+    }
+}
+
+template<typename Average>
+Downsampler::RowFunction Downsampler::floatRowFunction(bool exactHalf) const
+{
+    return exactHalf ? &Downsampler::halveFloat<Average> : &Downsampler::areaAverage<Average>;
+}
+
+//Public:
+void Downsampler::downsampleRows(int firstRow, int rows)
+{
+    qsizetype pitch = mTarget.bytesPerLine();
+    for(int y = firstRow; y < firstRow + rows; y++)
+        (this->*mRowFunction)(y, mTargetBits + y * pitch);
+}
+
+QImage Downsampler::target() const { return mTarget; }
@@ -0,0 +1,71 @@
+#ifndef DOWNSAMPLER_H
+#define DOWNSAMPLER_H
+
+// Qt Includes
+#include <QImage>
+
+// Standard Library Includes
+#include <vector>
+
+/* Box filters an RGB888 or RGBA8888(_Premultiplied) image down to at most half its size in each dimension,
+ * as needed to produce the next level of a mip-map chain. Exact halvings average each 2x2 square directly
+ * (vectorized for premultiplied/opaque data), while odd sizes weight each source pixel by how much of it falls
+ * under the output pixel, which is never more than MAX_TAPS pixels along either axis.
+ *
+ * Straight alpha color is weighted by alpha so that transparent pixels don't bleed into their neighbors. When
+ * 'srgb' is set, color is averaged in linear light instead of in its stored sRGB encoding.
+ *
+ * Target rows are independent of each other, so they can be produced in any order and concurrently.
+ */
+class Downsampler
+{
+//-Aliases----------------------------------------------------------------------------------------------------------
+private:
+    using RowFunction = void (Downsampler::*)(int y, uchar* out) const;
+
+//-Class Members----------------------------------------------------------------------------------------------------
+private:
+    static const int MAX_TAPS = 3; // Per axis, as the target is never smaller than half the source
+
+//-Class Structs----------------------------------------------------------------------------------------------------
+private:
+    // Source pixels covered by one target pixel along an axis, weighted by how much of each is covered
+    struct AxisTaps
+    {
+        int first;
+        int count;
+        float weights[MAX_TAPS];
+    };
+
+//-Instance Members-------------------------------------------------------------------------------------------------
+private:
+    const QImage& mSource;
+    QImage mTarget;
+    uchar* mTargetBits; // Taken once, since scanLine() isn't safe to call from several threads
+    RowFunction mRowFunction;
+    std::vector<AxisTaps> mXTaps;
+    std::vector<AxisTaps> mYTaps;
+
+//-Constructor-------------------------------------------------------------------------------------------------------
+public:
+    Downsampler(const QImage& source, const QSize& size, bool srgb = false);
+
+//-Class Functions--------------------------------------------------------------------------------------------------
+private:
+    static std::vector<AxisTaps> areaTaps(int sourceLength, int targetLength);
+
+//-Instance Functions----------------------------------------------------------------------------------------------
+private:
+    // Each produces one target row; the float ones are specialized on how color is averaged
+    void halve(int y, uchar* out) const;
+    void halveStraight(int y, uchar* out) const;
+    template<typename Average> void halveFloat(int y, uchar* out) const;
+    template<typename Average> void areaAverage(int y, uchar* out) const;
+    template<typename Average> RowFunction floatRowFunction(bool exactHalf) const;
+
+public:
+    void downsampleRows(int firstRow, int rows);
+    QImage target() const;
+};
+
+#endif // DOWNSAMPLER_H
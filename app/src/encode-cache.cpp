@@ -0,0 +1,136 @@
+// Unit Includes
+#include "encode-cache.h"
+
+// Qt Includes
+#include <QBuffer>
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QFile>
+#include <QUuid>
+
+// Project Includes
+#include "project_vars.h"
+#include "klei/k-tex-io.h"
+
+//===============================================================================================================
+// UNIT ONLY
+//===============================================================================================================
+namespace
+{
+    bool sameHeader(const KTex::Header& a, const KTex::Header& b)
+    {
+        return a.platform() == b.platform() && a.pixelFormat() == b.pixelFormat() && a.textureType() == b.textureType() &&
+               a.flagOne() == b.flagOne() && a.flagTwo() == b.flagTwo();
+    }
+
+    bool sameMipMap(const KTex::MipMapInfo& a, const KTex::MipMapInfo& b)
+    {
+        return a.width == b.width && a.height == b.height && a.pitch == b.pitch &&
+               a.dataSize == b.dataSize && a.dataOffset == b.dataOffset;
+    }
+
+    bool isIntact(const QByteArray& tex, const KTex::Info& expected)
+    {
+        // Only the metadata is parsed, which along with the total length catches damaged or truncated entries
+        QBuffer texBuffer;
+        texBuffer.setData(tex);
+        KTex::Info info;
+        KTexReader texReader(&texBuffer);
+        if(texReader.readInfo(info).isFailure() || !sameHeader(info.header, expected.header) ||
+           info.mipMaps.size() != expected.mipMaps.size())
+            return false;
+
+        for(qsizetype i = 0; i < info.mipMaps.size(); i++)
+            if(!sameMipMap(info.mipMaps.at(i), expected.mipMaps.at(i)))
+                return false;
+
+        qint64 dataEnd = expected.mipMaps.isEmpty() ? KTex::Header::BYTE_COUNT :
+                                                      expected.mipMaps.constLast().dataOffset + expected.mipMaps.constLast().dataSize;
+        return dataEnd == tex.size();
+    }
+}
+
+//===============================================================================================================
+// EncodeCache
+//===============================================================================================================
+
+//-Constructor-------------------------------------------------------------------------------------------------
+//Public:
+EncodeCache::EncodeCache(const QString& dirPath) :
+    mDir(dirPath)
+{}
+
+//-Class Functions----------------------------------------------------------------------------------------------
+//Public:
+QString EncodeCache::key(const QImage& image, const ToTexConverter::Options& options)
+{
+    // Everything that determines the output, apart from the pixels themselves. The codec's kernel and library
+    // are included since different instruction sets or library releases aren't guaranteed to match bit for bit
+    const BlockCodec* codec = options.codec ? options.codec : BlockCodec::preferredEncoder(options.pixelFormat);
+    QByteArray settings;
+    QDataStream settingsStream(&settings, QIODevice::WriteOnly);
+    settingsStream << QString::fromLatin1(PROJECT_VERSION_STR) << REVISION
+                   << quint8(options.platform) << quint8(options.textureType) << quint8(options.pixelFormat)
+                   << options.generateMipMaps << options.premultiplyAlpha << options.srgbMipMaps
+                   << int(options.quality) << (codec ? codec->name() : QString())
+                   << (codec ? codec->kernel() : QString()) << (codec ? codec->libraryVersion() : QString())
+                   << int(image.format()) << image.width() << image.height() << image.colorTable();
+
+    QCryptographicHash hash(QCryptographicHash::Blake2b_256);
+    hash.addData(settings);
+
+    // Only the bytes of each row that hold pixels, since the padding is undefined
+    qsizetype rowSize = (qsizetype(image.width()) * image.depth() + 7) / 8;
+    for(int y = 0; y < image.height(); y++)
+        hash.addData(QByteArrayView(image.constScanLine(y), rowSize));
+
+    return QString::fromLatin1(hash.result().toHex());
+}
+
+//-Instance Functions--------------------------------------------------------------------------------------------
+//Private:
+QString EncodeCache::entryPath(const QString& key) const { return mDir.absoluteFilePath(ENTRY_TEMPLATE.arg(key)); }
+
+//Public:
+bool EncodeCache::fetch(const QString& key, const KTex::Info& expected, QByteArray& tex) const
+{
+    QFile entry(entryPath(key));
+    if(!entry.open(QIODevice::ReadOnly))
+        return false;
+
+    tex = entry.readAll();
+    if(entry.error() != QFileDevice::NoError)
+        return false;
+
+    // An entry that doesn't hold what the key says it should is a miss, and is dropped so that it's replaced
+    if(!isIntact(tex, expected))
+    {
+        entry.close();
+        entry.remove();
+        tex.clear();
+        return false;
+    }
+
+    return true;
+}
+
+bool EncodeCache::store(const QString& key, const QString& texPath) const
+{
+    if(!mDir.mkpath(u"."_s))
+        return false;
+
+    // Copy under a unique name first so that concurrent runs never see a partial entry
+    QString entry = entryPath(key);
+    QString staging = entry + u'.' + QUuid::createUuid().toString(QUuid::WithoutBraces);
+    if(!QFile::copy(texPath, staging))
+        return false;
+
+    // Another run may have stored the same entry in the meantime, which is just as good
+    if(!QFile::rename(staging, entry))
+    {
+        QFile::remove(staging);
+        return QFile::exists(entry);
+    }
+
+    return true;
+}
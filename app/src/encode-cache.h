@@ -0,0 +1,44 @@
+#ifndef ENCODE_CACHE_H
+#define ENCODE_CACHE_H
+
+// Qt Includes
+#include <QDir>
+
+// Project Includes
+#include "conversion.h"
+
+/* Content addressed store of encoded TEX files. Entries are keyed by a hash of the source image's pixels,
+ * the conversion options that affect the output, and the encoder version, so an entry can be reused whenever
+ * the same image is encoded the same way again.
+ */
+class EncodeCache
+{
+//-Class Members----------------------------------------------------------------------------------------------------
+private:
+    static inline const QString ENTRY_TEMPLATE = u"%1.tex"_s;
+
+    // Bump whenever encoder output changes in a way the version doesn't capture
+    static const int REVISION = 1;
+
+//-Instance Members-------------------------------------------------------------------------------------------------
+private:
+    QDir mDir;
+
+//-Constructor-------------------------------------------------------------------------------------------------------
+public:
+    EncodeCache(const QString& dirPath);
+
+//-Class Functions--------------------------------------------------------------------------------------------------
+public:
+    static QString key(const QImage& image, const ToTexConverter::Options& options);
+
+//-Instance Functions----------------------------------------------------------------------------------------------
+private:
+    QString entryPath(const QString& key) const;
+
+public:
+    bool fetch(const QString& key, const KTex::Info& expected, QByteArray& tex) const;
+    bool store(const QString& key, const QString& texPath) const;
+};
+
+#endif // ENCODE_CACHE_H
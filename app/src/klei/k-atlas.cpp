@@ -318,9 +318,10 @@ QMap<QString, QImage> KDeatlaser::extractElements(const QImage& atlas, const QMa
 {
     QMap<QString, QImage> namedImages;
 
+    // Converting after copying means only the parts of the atlas that are used get touched
     QMap<QString, QRect>::const_iterator i;
     for(i = elements.constBegin(); i != elements.constEnd(); i++)
-        namedImages[i.key()] = atlas.copy(i.value());
+        namedImages[i.key()] = atlas.copy(i.value()).convertToFormat(QImage::Format_ARGB32);
 
     return namedImages;
 }
@@ -329,10 +330,7 @@ QMap<QString, QImage> KDeatlaser::extractElements(const QImage& atlas, const QMa
 //Public:
 QMap<QString, QImage> KDeatlaser::process() const
 {
-    // Convert to "standard" format (not needed, but hey)
-    QImage standardImage = mAtlas.image.convertToFormat(QImage::Format_ARGB32);
-
-    // Extract
-    return extractElements(standardImage, mAtlas.elements);
+    // Extract, in "standard" format (not needed, but hey)
+    return extractElements(mAtlas.image, mAtlas.elements);
 
 }
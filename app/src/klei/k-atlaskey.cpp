@@ -39,9 +39,9 @@
 namespace
 {
 
-QRect flipElement(const QRect& element, const QImage& image)
+QRect flipElement(const QRect& element, int imageHeight)
 {
-    return {QPoint(element.x(), (image.height() - 1) - element.bottom()), element.size()};
+    return {QPoint(element.x(), (imageHeight - 1) - element.bottom()), element.size()};
 }
 
 }
@@ -109,7 +109,7 @@ QMap<QString, QRectF> KAtlasKeyGenerator::translateElements() const
     for(auto i = mAtlas.elements.constBegin(); i != mAtlas.elements.constEnd(); i++)
     {
         // Flip
-        QRect fi = flipElement(*i, mAtlas.image);
+        QRect fi = flipElement(*i, mAtlas.image.height());
 
         // Map to UV coordinate space
         // + 0.5 to correspond to center of edge pixels
@@ -143,20 +143,28 @@ KAtlasKey KAtlasKeyGenerator::process() const
 //===============================================================================================================
 
 //-Constructor-------------------------------------------------------------------------------------------------
-KAtlasKeyParser::KAtlasKeyParser(const KAtlasKey& atlasKey, const QImage& atlasImage) :
+KAtlasKeyParser::KAtlasKeyParser(const KAtlasKey& atlasKey, const QSize& atlasSize) :
     mAtlasKey(atlasKey),
-    mAtlasImage(atlasImage)
+    mAtlasSize(atlasSize)
 {}
 
 //-Instance Functions--------------------------------------------------------------------------------------------
 //Private:
+QString KAtlasKeyParser::peelElementExtension(const QString& elementName) const
+{
+    QFileInfo nameInfo(elementName);
+    QString ext = KTex::standardExtension();
+    return nameInfo.suffix() == ext ? elementName.chopped(ext.length() + 1) : elementName;
+}
+
+//Public:
 QMap<QString, QRect> KAtlasKeyParser::translateElements() const
 {
     // Translate
     QMap<QString, QRect> translatedElements;
 
-    qreal xMax = mAtlasImage.width();
-    qreal yMax = mAtlasImage.height();
+    qreal xMax = mAtlasSize.width();
+    qreal yMax = mAtlasSize.height();
 
     for(auto i = mAtlasKey.elements().constBegin(); i != mAtlasKey.elements().constEnd(); i++)
     {
@@ -165,7 +173,7 @@ QMap<QString, QRect> KAtlasKeyParser::translateElements() const
         QPoint bottomRight(std::round(i->bottomRight().x() * xMax - 0.5), std::round(i->bottomRight().y() * yMax - 0.5));
 
         // Flip
-        QRect flipped = flipElement({topLeft, bottomRight}, mAtlasImage);
+        QRect flipped = flipElement({topLeft, bottomRight}, mAtlasSize.height());
 
 
         // Convert name if needed
@@ -178,22 +186,5 @@ QMap<QString, QRect> KAtlasKeyParser::translateElements() const
     return translatedElements;
 }
 
-QString KAtlasKeyParser::peelElementExtension(const QString& elementName) const
-{
-    QFileInfo nameInfo(elementName);
-    QString ext = KTex::standardExtension();
-    return nameInfo.suffix() == ext ? elementName.chopped(ext.length() + 1) : elementName;
-}
-
-//Public:
-KAtlas KAtlasKeyParser::process()
-{
-    KAtlas atlas;
-    atlas.image = mAtlasImage;
-    atlas.elements = translateElements();
-
-    return atlas;
-}
-
 
 
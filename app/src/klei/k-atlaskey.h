@@ -63,19 +63,18 @@ class KAtlasKeyParser
 //-Instance Members-------------------------------------------------------------------------------------------------
 private:
     const KAtlasKey& mAtlasKey;
-    const QImage& mAtlasImage;
+    const QSize mAtlasSize;
 
 //-Constructor-------------------------------------------------------------------------------------------------------
 public:
-    KAtlasKeyParser(const KAtlasKey& atlasKey, const QImage& atlasImage);
+    KAtlasKeyParser(const KAtlasKey& atlasKey, const QSize& atlasSize);
 
 //-Instance Functions----------------------------------------------------------------------------------------------
 private:
-    QMap<QString, QRect> translateElements() const;
     QString peelElementExtension(const QString& elementName) const;
 
 public:
-    KAtlas process();
+    QMap<QString, QRect> translateElements() const; // Pixel areas of the elements, known before the atlas is decoded
 };
 
 #endif // KATLASKEY_H
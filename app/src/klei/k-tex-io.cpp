@@ -1,110 +1,308 @@
 // Unit Includes
 #include "k-tex-io.h"
 
+// Qt Includes
+#include <QtEndian>
+#include <QVarLengthArray>
+
+// System Includes
+#ifdef Q_OS_UNIX
+#include <sys/uio.h>
+#include <climits>
+#include <cerrno>
+#endif
+
+//===============================================================================================================
+// UNIT ONLY
+//===============================================================================================================
+namespace
+{
+    Qx::IoOpReport deviceReport(Qx::IoOpType op, Qx::IoOpResultType result, const QIODevice* device)
+    {
+        // Only file devices have a target that can be named in the report
+        if(auto file = qobject_cast<const QFileDevice*>(device))
+            return Qx::IoOpReport(op, result, *file);
+        else
+            return Qx::IoOpReport(op, result, QFile());
+    }
+
+    bool openDevice(QIODevice* device, QIODevice::OpenMode mode, bool& opened)
+    {
+        // Devices that are already open are used as is and left for their owner to close
+        opened = false;
+        if(device->isOpen())
+            return mode.testFlag(QIODevice::WriteOnly) ? device->isWritable() : device->isReadable();
+
+        opened = device->open(mode);
+        return opened;
+    }
+
+    quint32 packSpecifications(const KTex::Header& header, quint8 mipMapCount)
+    {
+        Qx::BitArray platformBits = Qx::BitArray::fromInteger(static_cast<int>(header.platform()));
+        platformBits.resize(KTex::Header::BL_PLATFORM_AC);
+        Qx::BitArray pixelFormatBits = Qx::BitArray::fromInteger(static_cast<int>(header.pixelFormat()));
+        pixelFormatBits.resize(KTex::Header::BL_PIXEL_FORMAT_AC);
+        Qx::BitArray textureTypeBits = Qx::BitArray::fromInteger(static_cast<int>(header.textureType()));
+        textureTypeBits.resize(KTex::Header::BL_TEXTURE_TYPE_AC);
+        Qx::BitArray mipMapCountBits = Qx::BitArray::fromInteger(mipMapCount);
+        mipMapCountBits.resize(KTex::Header::BL_MIP_MAP_COUNT_AC);
+
+        Qx::BitArray flagOneBit(KTex::Header::BL_FLAG_AC, header.flagOne());
+        Qx::BitArray flagTwoBit(KTex::Header::BL_FLAG_AC, header.flagTwo());
+        Qx::BitArray paddingBits(KTex::Header::BL_PADDING_AC, true);
+
+        Qx::BitArray specifcationBits(platformBits +
+                                      pixelFormatBits +
+                                      textureTypeBits +
+                                      mipMapCountBits +
+                                      flagOneBit +
+                                      flagTwoBit +
+                                      paddingBits);
+
+        return specifcationBits.toInteger<quint32>();
+    }
+
+    QByteArray serializeMetadata(const KTex::Info& info)
+    {
+        // Header and metadata table, exactly as they appear at the start of a TEX
+        QByteArray metadata(KTex::Header::BYTE_COUNT + info.mipMaps.count() * KTex::MipMapImage::METADATA_BYTE_COUNT, Qt::Uninitialized);
+        char* field = metadata.data();
+
+        QByteArray magicNumber = KTex::Header::MAGIC_NUM.toUtf8();
+        field = std::copy(magicNumber.cbegin(), magicNumber.cend(), field);
+        qToLittleEndian<quint32>(packSpecifications(info.header, info.mipMaps.count()), field);
+        field += sizeof(quint32);
+
+        for(const KTex::MipMapInfo& mipMap : info.mipMaps)
+        {
+            qToLittleEndian<quint16>(mipMap.width, field);
+            field += sizeof(quint16);
+            qToLittleEndian<quint16>(mipMap.height, field);
+            field += sizeof(quint16);
+            qToLittleEndian<quint16>(mipMap.pitch, field);
+            field += sizeof(quint16);
+            qToLittleEndian<quint32>(mipMap.dataSize, field);
+            field += sizeof(quint32);
+        }
+
+        return metadata;
+    }
+}
+
 //===============================================================================================================
 // K_TEX_WRITER
 //===============================================================================================================
 
 //-Constructor-------------------------------------------------------------------------------------------------
 KTexWriter::KTexWriter(const KTex& sourceTex, const QString& targetFilePath) :
-    mStreamWriter(targetFilePath, Qx::WriteMode::Overwrite),
+    mTargetFile(targetFilePath),
+    mTarget(&mTargetFile),
+    mOpenedTarget(false),
     mSourceTex(sourceTex)
-{
-     mStreamWriter.setByteOrder(QDataStream::LittleEndian);
-}
+{}
+
+KTexWriter::KTexWriter(const KTex& sourceTex, QIODevice* targetDevice) :
+    mTarget(targetDevice),
+    mOpenedTarget(false),
+    mSourceTex(sourceTex)
+{}
+
+KTexWriter::KTexWriter(const KTex& sourceTex, QByteArray* targetData) :
+    mTargetBuffer(targetData),
+    mTarget(&mTargetBuffer),
+    mOpenedTarget(false),
+    mSourceTex(sourceTex)
+{}
 
 //-Instance Functions--------------------------------------------------------------------------------------------
 //Private:
-Qx::IoOpReport KTexWriter::writeHeader()
+Qx::IoOpReport KTexWriter::report(Qx::IoOpResultType result) const
 {
-    // Create specifications integer
-    Qx::BitArray platformBits = Qx::BitArray::fromInteger(static_cast<int>(mSourceTex.header().platform()));
-    platformBits.resize(KTex::Header::BL_PLATFORM_AC);
-    Qx::BitArray pixelFormatBits = Qx::BitArray::fromInteger(static_cast<int>(mSourceTex.header().pixelFormat()));
-    pixelFormatBits.resize(KTex::Header::BL_PIXEL_FORMAT_AC);
-    Qx::BitArray textureTypeBits = Qx::BitArray::fromInteger(static_cast<int>(mSourceTex.header().textureType()));
-    textureTypeBits.resize(KTex::Header::BL_TEXTURE_TYPE_AC);
-    Qx::BitArray mipMapCountBits = Qx::BitArray::fromInteger(mSourceTex.mipMapCount());
-    mipMapCountBits.resize(KTex::Header::BL_MIP_MAP_COUNT_AC);
+    return deviceReport(Qx::IO_OP_WRITE, result, mTarget);
+}
 
-    Qx::BitArray flagOneBit(KTex::Header::BL_FLAG_AC, mSourceTex.header().flagOne());
-    Qx::BitArray flagTwoBit(KTex::Header::BL_FLAG_AC, mSourceTex.header().flagTwo());
-    Qx::BitArray paddingBits(KTex::Header::BL_PADDING_AC, true);
+bool KTexWriter::writeSequential(const QByteArray& metadata)
+{
+    // Write header and metadata table
+    if(mTarget->write(metadata) != metadata.size())
+        return false;
 
-    Qx::BitArray specifcationBits(platformBits +
-                                  pixelFormatBits +
-                                  textureTypeBits +
-                                  mipMapCountBits +
-                                  flagOneBit +
-                                  flagTwoBit +
-                                  paddingBits);
+    // Write mip map data
+    for(const KTex::MipMapImage& mipMap : mSourceTex.mipMaps())
+    {
+        if(mTarget->write(mipMap.imageData()) != mipMap.imageData().size())
+            return false;
+    }
+
+    return true;
+}
+
+bool KTexWriter::writeGathered(const QByteArray& metadata)
+{
+#ifdef Q_OS_UNIX
+    // Hand the header, metadata table and all mip map data to the kernel as one list
+    QVarLengthArray<iovec, 16> vectors;
+    vectors.append(iovec{const_cast<char*>(metadata.constData()), static_cast<size_t>(metadata.size())});
+    for(const KTex::MipMapImage& mipMap : mSourceTex.mipMaps())
+    {
+        const QByteArray& data = mipMap.imageData();
+        if(!data.isEmpty())
+            vectors.append(iovec{const_cast<char*>(data.constData()), static_cast<size_t>(data.size())});
+    }
 
-    quint32 specifications = specifcationBits.toInteger<quint32>();
+    // Writes can be partial or limited in vector count, so continue from wherever the last one stopped
+    int fd = mTargetFile.handle();
+    iovec* next = vectors.data();
+    int remaining = vectors.size();
+    while(remaining > 0)
+    {
+        ssize_t written = ::writev(fd, next, std::min(remaining, IOV_MAX));
+        if(written <= 0)
+        {
+            if(written < 0 && errno == EINTR)
+                continue;
+            return false;
+        }
 
-    // Write magic number
-    mStreamWriter.writeRawData(KTex::Header::MAGIC_NUM.toUtf8());
+        while(remaining > 0 && static_cast<size_t>(written) >= next->iov_len)
+        {
+            written -= next->iov_len;
+            next++;
+            remaining--;
+        }
 
-    // Write specs
-    mStreamWriter << specifications;
+        if(remaining > 0)
+        {
+            next->iov_base = static_cast<char*>(next->iov_base) + written;
+            next->iov_len -= written;
+        }
+    }
 
-    // Return writer status
-    return mStreamWriter.status();
+    return true;
+#else
+    return writeSequential(metadata);
+#endif
 }
 
-Qx::IoOpReport KTexWriter::writeMipMapMetadata(const KTex::MipMapImage& mipMap)
+//Public:
+Qx::IoOpReport KTexWriter::write()
 {
-    // Write metadata fields
-    mStreamWriter << mipMap.width();
-    mStreamWriter << mipMap.height();
-    mStreamWriter << mipMap.pitch();
-    mStreamWriter << mipMap.imageDataSize();
+    // Open target
+    if(!openDevice(mTarget, QIODevice::WriteOnly | QIODevice::Truncate, mOpenedTarget))
+        return report(Qx::IO_ERR_OPEN);
+
+    // Header and metadata table are serialized together ahead of time
+    QByteArray metadata = serializeMetadata(mSourceTex.metadata());
+
+    // Write directly to files opened here, since nothing else can have data buffered for them,
+    // otherwise go through the device
+    bool gather = mOpenedTarget && mTarget == &mTargetFile;
+    bool written = gather ? writeGathered(metadata) : writeSequential(metadata);
+
+    // Close target, if it was opened here
+    if(mOpenedTarget)
+    {
+        mTarget->close();
+        mOpenedTarget = false;
+    }
 
-    // Return writer status
-    return mStreamWriter.status();
+    // Return status, checking for errors that only surface when file buffers are flushed
+    auto file = qobject_cast<const QFileDevice*>(mTarget);
+    bool flushed = !file || file->error() == QFileDevice::NoError;
+    return report(written && flushed ? Qx::IO_SUCCESS : Qx::IO_ERR_WRITE);
 }
 
-Qx::IoOpReport KTexWriter::writeMipMapData(const KTex::MipMapImage& mipMap)
-{
-    // Write data
-    mStreamWriter.writeRawData(mipMap.imageData());
+//===============================================================================================================
+// K_TEX_STREAM_WRITER
+//===============================================================================================================
+
+//-Constructor-------------------------------------------------------------------------------------------------
+KTexStreamWriter::KTexStreamWriter(const KTex::Info& metadata, const QString& targetFilePath) :
+    mTargetFile(targetFilePath),
+    mTarget(&mTargetFile),
+    mOpenedTarget(false),
+    mMetadata(metadata),
+    mMipMapsWritten(0)
+{}
+
+KTexStreamWriter::KTexStreamWriter(const KTex::Info& metadata, QIODevice* targetDevice) :
+    mTarget(targetDevice),
+    mOpenedTarget(false),
+    mMetadata(metadata),
+    mMipMapsWritten(0)
+{}
+
+KTexStreamWriter::KTexStreamWriter(const KTex::Info& metadata, QByteArray* targetData) :
+    mTargetBuffer(targetData),
+    mTarget(&mTargetBuffer),
+    mOpenedTarget(false),
+    mMetadata(metadata),
+    mMipMapsWritten(0)
+{}
 
-    // Return writer status
-    return mStreamWriter.status();
+//-Instance Functions--------------------------------------------------------------------------------------------
+//Private:
+Qx::IoOpReport KTexStreamWriter::report(Qx::IoOpResultType result) const
+{
+    return deviceReport(Qx::IO_OP_WRITE, result, mTarget);
 }
 
 //Public:
-Qx::IoOpReport KTexWriter::write()
+Qx::IoOpReport KTexStreamWriter::open()
 {
-    // Track status
-    Qx::IoOpReport status;
+    // Open target
+    if(!openDevice(mTarget, QIODevice::WriteOnly | QIODevice::Truncate, mOpenedTarget))
+        return report(Qx::IO_ERR_OPEN);
 
-    // Open file
-    if((status = mStreamWriter.openFile()).isFailure())
-        return status;
+    // Data sizes are fixed by format and dimensions, so the whole header and metadata table can be written up front
+    mMipMapsWritten = 0;
+    QByteArray metadata = serializeMetadata(mMetadata);
+    if(mTarget->write(metadata) != metadata.size())
+        return report(Qx::IO_ERR_WRITE);
 
-    // Write header
-    if((status = writeHeader()).isFailure())
-        return status;
+    // Return status
+    return report();
+}
 
-    // Write mip map metadata
-    for(const KTex::MipMapImage& mipMap : mSourceTex.mipMaps())
+Qx::IoOpReport KTexStreamWriter::writeMipMap(const KTex::MipMapImage& mipMap)
+{
+    // Mip maps must arrive in order and match the metadata that was already written
+    if(mMipMapsWritten >= mMetadata.mipMaps.count() ||
+       mipMap.imageDataSize() != mMetadata.mipMaps.at(mMipMapsWritten).dataSize)
     {
-        if((status = writeMipMapMetadata(mipMap)).isFailure())
-            return status;
+        qWarning("Streamed mipmap does not match the TEX metadata.");
+        return report(Qx::IO_ERR_WRITE);
     }
 
-    // Write mip map data
-    for(const KTex::MipMapImage& mipMap : mSourceTex.mipMaps())
-    {
-        if((status = writeMipMapData(mipMap)).isFailure())
-            return status;
-    }
+    // Write data
+    if(mTarget->write(mipMap.imageData()) != static_cast<qint64>(mipMap.imageDataSize()))
+        return report(Qx::IO_ERR_WRITE);
 
-    // Close file
-    mStreamWriter.closeFile();
+    mMipMapsWritten++;
 
     // Return status
-    return mStreamWriter.status();
+    return report();
+}
+
+Qx::IoOpReport KTexStreamWriter::close()
+{
+    // Don't leave a truncated TEX behind silently
+    bool complete = mMipMapsWritten == mMetadata.mipMaps.count();
+    if(!complete)
+        qWarning("TEX was closed before all mipmaps were written!");
+
+    // Close target, if it was opened here
+    if(mOpenedTarget)
+    {
+        mTarget->close();
+        mOpenedTarget = false;
+    }
+
+    // Return status, checking for errors that only surface when file buffers are flushed
+    auto file = qobject_cast<const QFileDevice*>(mTarget);
+    bool flushed = !file || file->error() == QFileDevice::NoError;
+    return report(complete && flushed ? Qx::IO_SUCCESS : Qx::IO_ERR_WRITE);
 }
 
 //===============================================================================================================
@@ -113,25 +311,71 @@ Qx::IoOpReport KTexWriter::write()
 
 //-Constructor-------------------------------------------------------------------------------------------------
 KTexReader::KTexReader(const QString& sourceFilePath, KTex& targetTex, bool anyPixelFormat) :
-    mStreamReader(sourceFilePath),
-    mTargetTex(targetTex),
+    mSourceFile(std::make_shared<QFile>(sourceFilePath)),
+    mSource(mSourceFile.get()),
+    mOpenedSource(false),
+    mSourcePos(0),
+    mTargetTex(&targetTex),
     mAnyPixelFormat(anyPixelFormat),
-    mMipMapCount(0)
-{
-    mStreamReader.setByteOrder(QDataStream::LittleEndian);
-}
+    mReadMode(ReadMode::Buffered),
+    mMipMapCount(0),
+    mFirstMipMap(0),
+    mMipMapLimit(-1)
+{}
+
+KTexReader::KTexReader(const QString& sourceFilePath, bool anyPixelFormat) :
+    mSourceFile(std::make_shared<QFile>(sourceFilePath)),
+    mSource(mSourceFile.get()),
+    mOpenedSource(false),
+    mSourcePos(0),
+    mTargetTex(nullptr),
+    mAnyPixelFormat(anyPixelFormat),
+    mReadMode(ReadMode::Buffered),
+    mMipMapCount(0),
+    mFirstMipMap(0),
+    mMipMapLimit(-1)
+{}
+
+KTexReader::KTexReader(QIODevice* sourceDevice, KTex& targetTex, bool anyPixelFormat) :
+    mSource(sourceDevice),
+    mOpenedSource(false),
+    mSourcePos(0),
+    mTargetTex(&targetTex),
+    mAnyPixelFormat(anyPixelFormat),
+    mReadMode(ReadMode::Buffered),
+    mMipMapCount(0),
+    mFirstMipMap(0),
+    mMipMapLimit(-1)
+{}
+
+KTexReader::KTexReader(QIODevice* sourceDevice, bool anyPixelFormat) :
+    mSource(sourceDevice),
+    mOpenedSource(false),
+    mSourcePos(0),
+    mTargetTex(nullptr),
+    mAnyPixelFormat(anyPixelFormat),
+    mReadMode(ReadMode::Buffered),
+    mMipMapCount(0),
+    mFirstMipMap(0),
+    mMipMapLimit(-1)
+{}
 
 //-Instance Functions--------------------------------------------------------------------------------------------
 //Private:
+Qx::IoOpReport KTexReader::report(Qx::IoOpResultType result) const
+{
+    return deviceReport(Qx::IO_OP_READ, result, mSource);
+}
+
 Qx::IoOpReport KTexReader::checkFileSupport(QByteArrayView magicNumberRaw)
 {
     if(QString::fromUtf8(magicNumberRaw) != KTex::Header::MAGIC_NUM)
     {
         qWarning("Incorrect magic number.");
-        return Qx::IoOpReport(Qx::IO_OP_READ, Qx::IO_ERR_READ, mStreamReader.file());
+        return report(Qx::IO_ERR_READ);
     }
 
-    return mStreamReader.status();
+    return report();
 }
 
 Qx::IoOpReport KTexReader::checkFileSupport(quint8 platformRaw, quint8 pixelFormatRaw, quint8 textureTypeRaw)
@@ -141,10 +385,10 @@ Qx::IoOpReport KTexReader::checkFileSupport(quint8 platformRaw, quint8 pixelForm
        !KTex::supportedTextureType(textureTypeRaw))
     {
         qWarning("TEX is unsupported.");
-        return Qx::IoOpReport(Qx::IO_OP_READ, Qx::IO_ERR_READ, mStreamReader.file());
+        return report(Qx::IO_ERR_READ);
     }
 
-    return mStreamReader.status();
+    return report();
 }
 
 Qx::IoOpReport KTexReader::parsePreCavesSpecs(const Qx::BitArray& specifcationBits)
@@ -168,15 +412,15 @@ Qx::IoOpReport KTexReader::parsePreCavesSpecs(const Qx::BitArray& specifcationBi
         return specsCheck;
 
     // Assign values
-    mTargetTex.header().setPlatform(static_cast<KTex::Header::Platform>(platformRaw));
-    mTargetTex.header().setPixelFormat(static_cast<KTex::Header::PixelFormat>(pixelFormatRaw));
-    mTargetTex.header().setTextureType(static_cast<KTex::Header::TextureType>(textureTypeRaw));
-    mTargetTex.header().setFlagOne(flagOneRaw);
-    mTargetTex.header().setFlagTwo(false);
+    mInfo.header.setPlatform(static_cast<KTex::Header::Platform>(platformRaw));
+    mInfo.header.setPixelFormat(static_cast<KTex::Header::PixelFormat>(pixelFormatRaw));
+    mInfo.header.setTextureType(static_cast<KTex::Header::TextureType>(textureTypeRaw));
+    mInfo.header.setFlagOne(flagOneRaw);
+    mInfo.header.setFlagTwo(false);
     mMipMapCount = mipMapCountRaw; // Track within reader for later
 
     // Return status
-    return mStreamReader.status();
+    return report();
 }
 
 Qx::IoOpReport KTexReader::parsePostCavesSpecs(const Qx::BitArray& specifcationBits)
@@ -202,31 +446,29 @@ Qx::IoOpReport KTexReader::parsePostCavesSpecs(const Qx::BitArray& specifcationB
         return specsCheck;
 
     // Assign values
-    mTargetTex.header().setPlatform(static_cast<KTex::Header::Platform>(platformRaw));
-    mTargetTex.header().setPixelFormat(static_cast<KTex::Header::PixelFormat>(pixelFormatRaw));
-    mTargetTex.header().setTextureType(static_cast<KTex::Header::TextureType>(textureTypeRaw));
-    mTargetTex.header().setFlagOne(flagOneRaw);
-    mTargetTex.header().setFlagTwo(flagTwoRaw);
+    mInfo.header.setPlatform(static_cast<KTex::Header::Platform>(platformRaw));
+    mInfo.header.setPixelFormat(static_cast<KTex::Header::PixelFormat>(pixelFormatRaw));
+    mInfo.header.setTextureType(static_cast<KTex::Header::TextureType>(textureTypeRaw));
+    mInfo.header.setFlagOne(flagOneRaw);
+    mInfo.header.setFlagTwo(flagTwoRaw);
     mMipMapCount = mipMapCountRaw; // Track within reader for later
 
     // Return status
-    return mStreamReader.status();
+    return report();
 }
 
-Qx::IoOpReport KTexReader::readHeader()
+Qx::IoOpReport KTexReader::parseHeader(QByteArrayView headerRaw)
 {
-    // Read magic number
-    QByteArray magicNumber;
-    mStreamReader.readRawData(magicNumber, KTex::Header::MAGIC_NUM.size());
+    // Start fresh
+    mInfo = KTex::Info();
 
     // Make sure file is correct format
     Qx::IoOpReport magicCheck;
-    if((magicCheck = checkFileSupport(magicNumber)).isFailure())
+    if((magicCheck = checkFileSupport(headerRaw.first(KTex::Header::MAGIC_NUM.size()))).isFailure())
         return magicCheck;
 
-    // Read specification int
-    quint32 specifications;
-    mStreamReader >> specifications;
+    // Parse specification int
+    quint32 specifications = qFromLittleEndian<quint32>(headerRaw.sliced(KTex::Header::MAGIC_NUM.size()).data());
 
     // Parse specifications based on their version
     Qx::BitArray specificationBits = Qx::BitArray::fromInteger<quint32>(specifications);
@@ -240,99 +482,427 @@ Qx::IoOpReport KTexReader::readHeader()
         return specCheck;
 
     // Reserve space for known mipmap count
-    mTargetTex.mipMaps().reserve(mMipMapCount);
+    mInfo.mipMaps.reserve(mMipMapCount);
 
     // Return status
-    return mStreamReader.status();
+    return report();
 }
 
-Qx::IoOpReport KTexReader::readMipMapMetadata()
+Qx::IoOpReport KTexReader::parseMipMapMetadata(QByteArrayView metadataRaw)
 {
     // Mipmap to add
-    KTex::MipMapImage mipMap;
+    KTex::MipMapInfo mipMap;
+    const char* field = metadataRaw.data();
 
-    // Read metadata
-    quint16 mipMapWidth;
-    mStreamReader >> mipMapWidth;
-    mipMap.setWidth(mipMapWidth);
+    // Parse metadata
+    mipMap.width = qFromLittleEndian<quint16>(field);
+    field += sizeof(quint16);
 
-    quint16 mipMapHeight;
-    mStreamReader >> mipMapHeight;
-    mipMap.setHeight(mipMapHeight);
+    mipMap.height = qFromLittleEndian<quint16>(field);
+    field += sizeof(quint16);
 
-    quint16 mipMapPitch;
-    mStreamReader >> mipMapPitch;
+    mipMap.pitch = qFromLittleEndian<quint16>(field);
+    field += sizeof(quint16);
 
     // Manually correct non-compliant mipmaps that report 0 pitch (*cough* matt's tools *cough*)
-    if(mipMapPitch == 0)
+    if(mipMap.pitch == 0)
     {
-        auto pf = mTargetTex.header().pixelFormat();
+        auto pf = mInfo.header.pixelFormat();
         bool isCompressed = pf != KTex::Header::PixelFormat::RGB && pf != KTex::Header::PixelFormat::RGBA;
 
         if(isCompressed)
         {
             // Equivalent to squish::GetStorageRequirements(mipMapWidth, 1, squishFlag), but avoids squish include
-            mipMapPitch = ((mipMapWidth + 3) / 4) * (pf == KTex::Header::PixelFormat::DXT1 ? 8 : 16);
+            mipMap.pitch = ((mipMap.width + 3) / 4) * (pf == KTex::Header::PixelFormat::DXT1 ? 8 : 16);
         }
         else
-            mipMapPitch = mipMapWidth * 4; // Used QImage formats are always 32-bit aligned.
+            mipMap.pitch = mipMap.width * 4; // Used QImage formats are always 32-bit aligned.
     }
-    mipMap.setPitch(mipMapPitch);
 
-    quint32 mipMapDataSize;
-    mStreamReader >> mipMapDataSize;
-    mipMap.setImageDataSize(mipMapDataSize);
+    mipMap.dataSize = qFromLittleEndian<quint32>(field);
+
+    // Data is stored contiguously, in order, after the metadata table
+    if(mInfo.mipMaps.isEmpty())
+        mipMap.dataOffset = KTex::Header::BYTE_COUNT + mMipMapCount * KTex::MipMapImage::METADATA_BYTE_COUNT;
+    else
+        mipMap.dataOffset = mInfo.mipMaps.constLast().dataOffset + mInfo.mipMaps.constLast().dataSize;
 
     // Add mipmap
-    mTargetTex.mipMaps().append(mipMap);
+    mInfo.mipMaps.append(mipMap);
 
     // Return status
-    return mStreamReader.status();
+    return report();
 }
 
-Qx::IoOpReport KTexReader::readMipMapData(int i)
+Qx::IoOpReport KTexReader::parseMipMapTable(QByteArrayView tableRaw)
 {
-    // Read data chunk for given mipmap
-    mStreamReader.readRawData(mTargetTex.mipMaps()[i].imageData(), mTargetTex.mipMaps()[i].imageDataSize());
+    // Track status
+    Qx::IoOpReport status;
+
+    // Header must have been parsed already, as it holds the table's size
+    if(tableRaw.size() < mMipMapCount * KTex::MipMapImage::METADATA_BYTE_COUNT)
+        return report(Qx::IO_ERR_CURSOR_OOB);
+
+    for(int i = 0; i < mMipMapCount; i++)
+    {
+        if((status = parseMipMapMetadata(tableRaw.sliced(i * KTex::MipMapImage::METADATA_BYTE_COUNT))).isFailure())
+            return status;
+    }
 
     // Return status
-    return mStreamReader.status();
+    return report();
 }
 
-//Public:
-Qx::IoOpReport KTexReader::read()
+Qx::IoOpReport KTexReader::parseMetadata(QByteArrayView fileData)
 {
     // Track status
     Qx::IoOpReport status;
 
-    // Open file
-    if((status = mStreamReader.openFile()).isFailure())
+    // Parse header
+    if(fileData.size() < KTex::Header::BYTE_COUNT)
+        return report(Qx::IO_ERR_CURSOR_OOB);
+
+    if((status = parseHeader(fileData.first(KTex::Header::BYTE_COUNT))).isFailure())
         return status;
 
-    // Read header
-    if((status = readHeader()).isFailure())
+    // Parse mip map metadata table
+    return parseMipMapTable(fileData.sliced(KTex::Header::BYTE_COUNT));
+}
+
+Qx::IoOpReport KTexReader::checkMipMapData(const KTex::MipMapInfo& mipMap) const
+{
+    /* Data that's only handed off raw can be any size, but decoders read as much as the format requires, so
+     * undersized data is rejected. Padding and extra data are tolerated here and left for verify to report.
+     */
+    if(mAnyPixelFormat || mipMap.width == 0 || mipMap.height == 0)
+        return report();
+
+    auto pf = mInfo.header.pixelFormat();
+    qint64 required;
+    if(pf == KTex::Header::PixelFormat::RGB || pf == KTex::Header::PixelFormat::RGBA)
+    {
+        // Uncompressed rows are read at the stated pitch, which must at least fit a row
+        qint64 rowSize = qint64(mipMap.width) * (pf == KTex::Header::PixelFormat::RGB ? 3 : 4);
+        if(mipMap.pitch < rowSize)
+        {
+            qWarning("Mip-map pitch is too small for its width.");
+            return report(Qx::IO_ERR_READ);
+        }
+
+        required = qint64(mipMap.pitch) * (mipMap.height - 1) + rowSize;
+    }
+    else
+        required = KTex::standardImageDataSize(pf, mipMap.width, mipMap.height);
+
+    if(mipMap.dataSize < required)
+    {
+        qWarning("Mip-map data is too small for its pixel format and dimensions.");
+        return report(Qx::IO_ERR_READ);
+    }
+
+    return report();
+}
+
+Qx::IoOpReport KTexReader::openSource()
+{
+    if(!openDevice(mSource, QIODevice::ReadOnly, mOpenedSource))
+        return report(Qx::IO_ERR_OPEN);
+
+    // Offsets are relative to the start of the TEX, which isn't necessarily the start of the device
+    mSourcePos = 0;
+
+    return report();
+}
+
+void KTexReader::closeSource()
+{
+    if(mOpenedSource)
+    {
+        mSource->close();
+        mOpenedSource = false;
+    }
+}
+
+Qx::IoOpReport KTexReader::readSource(char* data, qint64 size)
+{
+    // Sequential devices (e.g. pipes) may deliver data in pieces
+    for(qint64 remaining = size; remaining > 0;)
+    {
+        qint64 count = mSource->read(data, remaining);
+        if(count < 0 || (count == 0 && !mSource->waitForReadyRead(-1)))
+            return report(Qx::IO_ERR_CURSOR_OOB);
+
+        data += count;
+        remaining -= count;
+    }
+
+    mSourcePos += size;
+    return report();
+}
+
+Qx::IoOpReport KTexReader::skipSource(qint64 size)
+{
+    // Skipping instead of seeking allows for sequential devices
+    for(qint64 remaining = size; remaining > 0;)
+    {
+        qint64 count = mSource->skip(remaining);
+        if(count < 0 || (count == 0 && !mSource->waitForReadyRead(-1)))
+            return report(Qx::IO_ERR_CURSOR_OOB);
+
+        remaining -= count;
+    }
+
+    mSourcePos += size;
+    return report();
+}
+
+Qx::IoOpReport KTexReader::readMetadata()
+{
+    // Track status
+    Qx::IoOpReport status;
+
+    // Read header, which is needed to know the metadata table's size
+    QByteArray header(KTex::Header::BYTE_COUNT, Qt::Uninitialized);
+    if((status = readSource(header.data(), header.size())).isFailure())
         return status;
 
-    // Read mip map metadata
-    for(int i = 0; i < mMipMapCount; i++)
+    if((status = parseHeader(header)).isFailure())
+        return status;
+
+    // Read and parse the metadata table
+    QByteArray table(mMipMapCount * KTex::MipMapImage::METADATA_BYTE_COUNT, Qt::Uninitialized);
+    if((status = readSource(table.data(), table.size())).isFailure())
+        return status;
+
+    return parseMipMapTable(table);
+}
+
+Qx::IoOpReport KTexReader::readBuffered()
+{
+    // Track status
+    Qx::IoOpReport status;
+
+    // Read metadata
+    if((status = readMetadata()).isFailure())
+        return status;
+
+    initializeTarget();
+
+    // Read mip map data, skipping past any levels that weren't selected
+    const QVector<KTex::MipMapInfo> selected = selectedMipMaps();
+    qsizetype firstMipMap = mTargetTex->mipMaps().size() - selected.size();
+    for(qsizetype i = 0; i < selected.size(); i++)
     {
-        if((status = readMipMapMetadata()).isFailure())
+        const KTex::MipMapInfo& mipMapInfo = selected.at(i);
+        if((status = checkMipMapData(mipMapInfo)).isFailure())
+            return status;
+
+        if((status = skipSource(mipMapInfo.dataOffset - mSourcePos)).isFailure())
+            return status;
+
+        KTex::MipMapImage& mipMap = mTargetTex->mipMaps()[firstMipMap + i];
+        mipMap.setImageDataSize(mipMapInfo.dataSize);
+
+        if((status = readSource(mipMap.imageData().data(), mipMapInfo.dataSize)).isFailure())
             return status;
     }
 
-    // Read mip map data
-    for(int i = 0; i < mMipMapCount; i++)
+    if(selected.size() == mInfo.mipMaps.size() && !mSource->atEnd())
+        qWarning("There was still data left in the file after reading all mipmaps!");
+
+    // Close source
+    closeSource();
+
+    // Return status
+    return report();
+}
+
+Qx::IoOpReport KTexReader::readMapped(QByteArrayView fileData, std::shared_ptr<const void> dataOwner)
+{
+    // Track status
+    Qx::IoOpReport status;
+
+    // Parse metadata in place
+    if((status = parseMetadata(fileData)).isFailure())
+        return status;
+
+    initializeTarget();
+
+    // View selected mip map data directly within the mapping
+    const QVector<KTex::MipMapInfo> selected = selectedMipMaps();
+    qsizetype firstMipMap = mTargetTex->mipMaps().size() - selected.size();
+    for(qsizetype i = 0; i < selected.size(); i++)
     {
-        if((status = readMipMapData(i)).isFailure())
+        const KTex::MipMapInfo& mipMapInfo = selected.at(i);
+        if((status = checkMipMapData(mipMapInfo)).isFailure())
             return status;
+
+        if(fileData.size() - mipMapInfo.dataOffset < static_cast<qint64>(mipMapInfo.dataSize))
+            return report(Qx::IO_ERR_CURSOR_OOB);
+
+        // Raw data arrays don't own their data and deep copy if modified, so the mapping is never written to
+        mTargetTex->mipMaps()[firstMipMap + i].imageData() = QByteArray::fromRawData(fileData.data() + mipMapInfo.dataOffset,
+                                                                                     mipMapInfo.dataSize);
     }
 
-    if(!mStreamReader.atEnd())
+    qint64 dataEnd = mInfo.mipMaps.isEmpty() ? KTex::Header::BYTE_COUNT : mInfo.mipMaps.constLast().dataOffset + mInfo.mipMaps.constLast().dataSize;
+    if(dataEnd < fileData.size())
         qWarning("There was still data left in the file after reading all mipmaps!");
+    else if(dataEnd > fileData.size()) // Selected mipmaps were checked above, so only unselected ones can be cut off
+        qWarning("The file is truncated within mipmaps that were not read.");
 
-    // Close file
-    mStreamReader.closeFile();
+    // Hand the data's owner off to the TEX, which keeps it alive for as long as its data is viewed
+    mTargetTex->mMappedSource = std::move(dataOwner);
 
     // Return status
-    return mStreamReader.status();
+    return report();
+}
+
+QVector<KTex::MipMapInfo> KTexReader::selectedMipMaps() const { return mInfo.mipMaps.mid(mFirstMipMap, mMipMapLimit); }
+
+void KTexReader::initializeTarget()
+{
+    const QVector<KTex::MipMapInfo> selected = selectedMipMaps();
+    mTargetTex->header() = mInfo.header;
+    mTargetTex->mipMaps().reserve(mTargetTex->mipMaps().size() + selected.size());
+
+    // Data is handled separately since how it is held depends on the read mode
+    for(const KTex::MipMapInfo& mipMapInfo : selected)
+    {
+        KTex::MipMapImage mipMap;
+        mipMap.setWidth(mipMapInfo.width);
+        mipMap.setHeight(mipMapInfo.height);
+        mipMap.setPitch(mipMapInfo.pitch);
+        mTargetTex->mipMaps().append(mipMap);
+    }
+}
+
+//Public:
+KTexReader::ReadMode KTexReader::readMode() const { return mReadMode; }
+void KTexReader::setReadMode(ReadMode mode) { mReadMode = mode; }
+
+void KTexReader::setMipMapSelection(int first, int count)
+{
+    // Only the selected levels are added to the target, starting with 'first'. A negative count selects all remaining levels
+    mFirstMipMap = std::max(first, 0);
+    mMipMapLimit = count;
+}
+
+KTex::Info KTexReader::metadata() const { return mInfo; }
+
+Qx::IoOpReport KTexReader::readInfo(KTex::Info& info)
+{
+    // Track status
+    Qx::IoOpReport status;
+
+    // Open source
+    if((status = openSource()).isFailure())
+        return status;
+
+    // Read only the header and metadata table, no pixel data is touched
+    status = readMetadata();
+    closeSource();
+
+    if(!status.isFailure())
+        info = mInfo;
+
+    return status;
+}
+
+Qx::IoOpReport KTexReader::read()
+{
+    Q_ASSERT(mTargetTex);
+
+    // Track status
+    Qx::IoOpReport status;
+
+    // Open source
+    if((status = openSource()).isFailure())
+        return status;
+
+    // Read through a mapping/view if requested and possible, otherwise fallback to copying
+    if(mReadMode == ReadMode::Mapped)
+    {
+        if(mSourceFile)
+        {
+            // The file is left open since closing it would unmap it
+            qint64 fileSize = mSourceFile->size();
+            if(uchar* mapping = fileSize > 0 ? mSourceFile->map(0, fileSize) : nullptr)
+                return readMapped(QByteArrayView(mapping, fileSize), mSourceFile);
+        }
+        else if(auto buffer = qobject_cast<QBuffer*>(mSource))
+        {
+            // Viewing a shallow copy of the buffer's data keeps it valid even if the buffer is later modified
+            auto data = std::make_shared<const QByteArray>(buffer->data());
+            status = readMapped(QByteArrayView(*data).sliced(buffer->pos()), data);
+            closeSource();
+            return status;
+        }
+    }
+
+    return readBuffered();
+}
+
+//===============================================================================================================
+// K_TEX_PREFETCHER
+//===============================================================================================================
+
+//-Constructor-------------------------------------------------------------------------------------------------
+KTexPrefetcher::KTexPrefetcher(const QStringList& filePaths, int depth) :
+    mFilePaths(filePaths),
+    mNextFetch(0)
+{
+    // Reads mostly wait on the source, so one thread per file in flight
+    depth = std::max(depth, 1);
+    mPool.setMaxThreadCount(depth);
+
+    for(int i = 0; i < depth; i++)
+        issueFetch();
+}
+
+//-Destructor------------------------------------------------------------------------------------------------
+KTexPrefetcher::~KTexPrefetcher() { mPool.waitForDone(); }
+
+//-Class Functions--------------------------------------------------------------------------------------------
+//Private:
+KTexPrefetcher::Fetch KTexPrefetcher::fetch(const QString& filePath)
+{
+    QFile file(filePath);
+    if(!file.open(QIODevice::ReadOnly))
+        return {QByteArray(), Qx::IoOpReport(Qx::IO_OP_READ, Qx::IO_ERR_OPEN, file)};
+
+    // Read the whole file in one go, which is far cheaper than many small reads on high latency storage
+    QByteArray data = file.readAll();
+    Qx::IoOpResultType result = file.error() == QFileDevice::NoError ? Qx::IO_SUCCESS : Qx::IO_ERR_READ;
+
+    return {data, Qx::IoOpReport(Qx::IO_OP_READ, result, file)};
+}
+
+//-Instance Functions--------------------------------------------------------------------------------------------
+//Private:
+void KTexPrefetcher::issueFetch()
+{
+    if(mNextFetch >= mFilePaths.count())
+        return;
+
+    // The promise is shared since pool tasks must be copyable
+    auto promise = std::make_shared<std::promise<Fetch>>();
+    mInFlight.push_back(promise->get_future());
+    mPool.start([promise, filePath = mFilePaths.at(mNextFetch++)]{ promise->set_value(fetch(filePath)); });
+}
+
+//Public:
+bool KTexPrefetcher::hasNext() const { return !mInFlight.empty(); }
+
+Qx::IoOpReport KTexPrefetcher::next(QByteArray& data)
+{
+    Q_ASSERT(hasNext());
+
+    // Files are handed out in order, with another fetch started for each one taken to keep the queue full
+    Fetch fetched = mInFlight.front().get();
+    mInFlight.pop_front();
+    issueFetch();
+
+    data = fetched.data;
+    return fetched.report;
 }
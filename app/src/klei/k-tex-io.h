@@ -3,10 +3,16 @@
 
 // Qt Includes
 #include <QFile>
+#include <QBuffer>
+#include <QThreadPool>
+
+// Standard Library Includes
+#include <memory>
+#include <future>
+#include <deque>
 
 // Qx Includes
-#include <qx/io/qx-filestreamwriter.h>
-#include <qx/io/qx-filestreamreader.h>
+#include <qx/io/qx-ioopreport.h>
 #include <qx/core/qx-bitarray.h>
 
 // Project Includes
@@ -19,37 +25,86 @@ private:
 
 //-Instance Members-------------------------------------------------------------------------------------------------
 private:
-    Qx::FileStreamWriter mStreamWriter;
+    QFile mTargetFile;
+    QBuffer mTargetBuffer;
+    QIODevice* mTarget;
+    bool mOpenedTarget;
     const KTex& mSourceTex;
 
 //-Constructor-------------------------------------------------------------------------------------------------------
 public:
-    KTexWriter(const KTex& sourceTex, const QString& targetfilePath);
+    KTexWriter(const KTex& sourceTex, const QString& targetFilePath);
+    KTexWriter(const KTex& sourceTex, QIODevice* targetDevice);
+    KTexWriter(const KTex& sourceTex, QByteArray* targetData);
 
 //-Instance Functions----------------------------------------------------------------------------------------------
 private:
-    Qx::IoOpReport writeHeader();
-    Qx::IoOpReport writeMipMapMetadata(const KTex::MipMapImage& mipMap);
-    Qx::IoOpReport writeMipMapData(const KTex::MipMapImage& mipMap);
+    Qx::IoOpReport report(Qx::IoOpResultType result = Qx::IO_SUCCESS) const;
+    bool writeSequential(const QByteArray& metadata);
+    bool writeGathered(const QByteArray& metadata);
 
 public:
     Qx::IoOpReport write();
 
 };
 
+class KTexStreamWriter
+{
+//-Instance Members-------------------------------------------------------------------------------------------------
+private:
+    QFile mTargetFile;
+    QBuffer mTargetBuffer;
+    QIODevice* mTarget;
+    bool mOpenedTarget;
+    const KTex::Info mMetadata;
+    int mMipMapsWritten;
+
+//-Constructor-------------------------------------------------------------------------------------------------------
+public:
+    KTexStreamWriter(const KTex::Info& metadata, const QString& targetFilePath);
+    KTexStreamWriter(const KTex::Info& metadata, QIODevice* targetDevice);
+    KTexStreamWriter(const KTex::Info& metadata, QByteArray* targetData);
+
+//-Instance Functions----------------------------------------------------------------------------------------------
+private:
+    Qx::IoOpReport report(Qx::IoOpResultType result = Qx::IO_SUCCESS) const;
+
+public:
+    Qx::IoOpReport open();
+    Qx::IoOpReport writeMipMap(const KTex::MipMapImage& mipMap);
+    Qx::IoOpReport close();
+};
+
 class KTexReader
 {
+//-Class Enums------------------------------------------------------------------------------------------------------
+public:
+    enum class ReadMode
+    {
+        Buffered, // Mip-map data is copied into buffers owned by the target TEX
+        Mapped // Mip-map data views a memory mapping of the source file (or the data of a source QBuffer) that is kept alive by the target TEX
+    };
+
 //-Class Members----------------------------------------------------------------------------------------------------
 private:
 
 //-Instance Members-------------------------------------------------------------------------------------------------
 private:
-    Qx::FileStreamReader mStreamReader;
-    KTex& mTargetTex;
+    std::shared_ptr<QFile> mSourceFile; // Only set when reading from a path
+    QIODevice* mSource;
+    bool mOpenedSource;
+    qint64 mSourcePos; // Tracked manually so that sequential devices can be read
+    KTex* mTargetTex;
     bool mAnyPixelFormat;
+    ReadMode mReadMode;
+
+    // Parsed metadata
+    KTex::Info mInfo;
 
     // Mipmap helper members
     quint8 mMipMapCount;
+    int mFirstMipMap;
+    int mMipMapLimit;
 
     // Status
     //bool* mSupported;
@@ -57,20 +112,87 @@ private:
 //-Constructor-------------------------------------------------------------------------------------------------------
 public:
     KTexReader(const QString& sourceFilePath, KTex& targetTex, bool anyPixelFormat = false);
+    KTexReader(const QString& sourceFilePath, bool anyPixelFormat = false); // For readInfo() only
+    KTexReader(QIODevice* sourceDevice, KTex& targetTex, bool anyPixelFormat = false);
+    KTexReader(QIODevice* sourceDevice, bool anyPixelFormat = false); // For readInfo() only
 
 //-Instance Functions----------------------------------------------------------------------------------------------
 private:
+    Qx::IoOpReport report(Qx::IoOpResultType result = Qx::IO_SUCCESS) const;
+
     Qx::IoOpReport checkFileSupport(QByteArrayView magicNumberRaw);
     Qx::IoOpReport checkFileSupport(quint8 platformRaw, quint8 pixelFormatRaw, quint8 textureTypeRaw);
 
     Qx::IoOpReport parsePreCavesSpecs(const Qx::BitArray& specifcationBits);
     Qx::IoOpReport parsePostCavesSpecs(const Qx::BitArray& specifcationBits);
-    Qx::IoOpReport readHeader();
-    Qx::IoOpReport readMipMapMetadata();
-    Qx::IoOpReport readMipMapData(int i);
+    Qx::IoOpReport parseHeader(QByteArrayView headerRaw);
+    Qx::IoOpReport parseMipMapMetadata(QByteArrayView metadataRaw);
+    Qx::IoOpReport parseMipMapTable(QByteArrayView tableRaw);
+    Qx::IoOpReport parseMetadata(QByteArrayView fileData);
+    Qx::IoOpReport checkMipMapData(const KTex::MipMapInfo& mipMap) const;
+
+    Qx::IoOpReport openSource();
+    void closeSource();
+    Qx::IoOpReport readSource(char* data, qint64 size);
+    Qx::IoOpReport skipSource(qint64 size);
+
+    Qx::IoOpReport readMetadata();
+    Qx::IoOpReport readBuffered();
+    Qx::IoOpReport readMapped(QByteArrayView fileData, std::shared_ptr<const void> dataOwner);
+    QVector<KTex::MipMapInfo> selectedMipMaps() const;
+    void initializeTarget();
 
 public:
+    ReadMode readMode() const;
+    void setReadMode(ReadMode mode);
+    void setMipMapSelection(int first, int count = -1);
+
+    KTex::Info metadata() const;
+
+    Qx::IoOpReport readInfo(KTex::Info& info);
     Qx::IoOpReport read();
 };
 
+class KTexPrefetcher
+{
+//-Class Structs----------------------------------------------------------------------------------------------------
+private:
+    struct Fetch
+    {
+        QByteArray data;
+        Qx::IoOpReport report;
+    };
+
+//-Class Members----------------------------------------------------------------------------------------------------
+public:
+    static const int DEFAULT_DEPTH = 4;
+
+//-Instance Members-------------------------------------------------------------------------------------------------
+private:
+    const QStringList mFilePaths;
+    QThreadPool mPool;
+    std::deque<std::future<Fetch>> mInFlight;
+    qsizetype mNextFetch;
+
+//-Constructor-------------------------------------------------------------------------------------------------------
+public:
+    KTexPrefetcher(const QStringList& filePaths, int depth = DEFAULT_DEPTH);
+
+//-Destructor-------------------------------------------------------------------------------------------------------
+public:
+    ~KTexPrefetcher();
+
+//-Class Functions--------------------------------------------------------------------------------------------------
+private:
+    static Fetch fetch(const QString& filePath);
+
+//-Instance Functions----------------------------------------------------------------------------------------------
+private:
+    void issueFetch();
+
+public:
+    bool hasNext() const;
+    Qx::IoOpReport next(QByteArray& data);
+};
+
 #endif // K_TEX_IO_H
@@ -1,6 +1,12 @@
 // Unit Includes
 #include "k-tex.h"
 
+// Qt Includes
+#include <QtEndian>
+
+// Standard Library Includes
+#include <bit>
+
 // Qx Includes
 #include <qx/core/qx-json.h>
 
@@ -15,6 +21,101 @@ struct MipMapMeta
     QX_JSON_STRUCT(width, height, pitch);
 };
 
+struct HashedMipMapMeta
+{
+    quint16 width;
+    quint16 height;
+    quint16 pitch;
+    QString xxh64;
+    QX_JSON_STRUCT(width, height, pitch, xxh64);
+};
+
+// XXH64, as specified by the reference xxHash implementation
+namespace Xxh64
+{
+    const quint64 PRIME_1 = 0x9E3779B185EBCA87ULL;
+    const quint64 PRIME_2 = 0xC2B2AE3D27D4EB4FULL;
+    const quint64 PRIME_3 = 0x165667B19E3779F9ULL;
+    const quint64 PRIME_4 = 0x85EBCA77C2B2AE63ULL;
+    const quint64 PRIME_5 = 0x27D4EB2F165667C5ULL;
+
+    quint64 round(quint64 acc, quint64 input)
+    {
+        acc += input * PRIME_2;
+        acc = std::rotl(acc, 31);
+        return acc * PRIME_1;
+    }
+
+    quint64 mergeRound(quint64 acc, quint64 val)
+    {
+        acc ^= round(0, val);
+        return acc * PRIME_1 + PRIME_4;
+    }
+
+    quint64 hash(QByteArrayView data, quint64 seed = 0)
+    {
+        const uchar* p = reinterpret_cast<const uchar*>(data.data());
+        const uchar* end = p + data.size();
+        quint64 h;
+
+        // Consume 32-byte stripes across four lanes
+        if(data.size() >= 32)
+        {
+            quint64 v1 = seed + PRIME_1 + PRIME_2;
+            quint64 v2 = seed + PRIME_2;
+            quint64 v3 = seed;
+            quint64 v4 = seed - PRIME_1;
+
+            for(const uchar* limit = end - 32; p <= limit; p += 32)
+            {
+                v1 = round(v1, qFromLittleEndian<quint64>(p));
+                v2 = round(v2, qFromLittleEndian<quint64>(p + 8));
+                v3 = round(v3, qFromLittleEndian<quint64>(p + 16));
+                v4 = round(v4, qFromLittleEndian<quint64>(p + 24));
+            }
+
+            h = std::rotl(v1, 1) + std::rotl(v2, 7) + std::rotl(v3, 12) + std::rotl(v4, 18);
+            h = mergeRound(h, v1);
+            h = mergeRound(h, v2);
+            h = mergeRound(h, v3);
+            h = mergeRound(h, v4);
+        }
+        else
+            h = seed + PRIME_5;
+
+        h += static_cast<quint64>(data.size());
+
+        // Consume the tail
+        for(; p + 8 <= end; p += 8)
+        {
+            h ^= round(0, qFromLittleEndian<quint64>(p));
+            h = std::rotl(h, 27) * PRIME_1 + PRIME_4;
+        }
+
+        if(p + 4 <= end)
+        {
+            h ^= static_cast<quint64>(qFromLittleEndian<quint32>(p)) * PRIME_1;
+            h = std::rotl(h, 23) * PRIME_2 + PRIME_3;
+            p += 4;
+        }
+
+        for(; p < end; p++)
+        {
+            h ^= *p * PRIME_5;
+            h = std::rotl(h, 11) * PRIME_1;
+        }
+
+        // Avalanche
+        h ^= h >> 33;
+        h *= PRIME_2;
+        h ^= h >> 29;
+        h *= PRIME_3;
+        h ^= h >> 32;
+
+        return h;
+    }
+}
+
 }
 
 //===============================================================================================================
@@ -65,9 +166,14 @@ quint32 KTex::MipMapImage::imageDataSize() const { return mImageData.size(); }
 QByteArray& KTex::MipMapImage::imageData() { return mImageData; }
 const QByteArray& KTex::MipMapImage::imageData() const { return mImageData; }
 
+QString KTex::MipMapImage::dataHash() const
+{
+    return QString::number(Xxh64::hash(mImageData), 16).rightJustified(16, u'0');
+}
+
 QByteArray KTex::MipMapImage::jsonMetadata() const
 {
-    MipMapMeta meta{mWidth, mHeight, mPitch};
+    HashedMipMapMeta meta{mWidth, mHeight, mPitch, dataHash()};
     QByteArray json;
     Qx::serializeJson(json, meta);
     return json;
@@ -78,6 +184,50 @@ void KTex::MipMapImage::setHeight(quint16 height) { mHeight = height; }
 void KTex::MipMapImage::setPitch(quint16 pitch) { mPitch = pitch; }
 void KTex::MipMapImage::setImageDataSize(quint32 size) { mImageData.resize(size); }
 
+//===============================================================================================================
+// K_TEX::MIP_MAP_INFO
+//===============================================================================================================
+
+//-Instance Functions--------------------------------------------------------------------------------------------
+//Public:
+QByteArray KTex::MipMapInfo::jsonMetadata() const
+{
+    MipMapMeta meta{width, height, pitch};
+    QByteArray json;
+    Qx::serializeJson(json, meta);
+    return json;
+}
+
+//===============================================================================================================
+// K_TEX::INFO
+//===============================================================================================================
+
+//-Instance Functions--------------------------------------------------------------------------------------------
+//Public:
+QString KTex::Info::toString(bool indent) const
+{
+    QStringList infoPoints;
+    infoPoints << u"Platform: "_s + PLATFORM_STRINGS[header.platform()];
+    auto pxForm = PIXEL_FORMAT_STRINGS.find(header.pixelFormat());
+    QString pxFormStr = pxForm != PIXEL_FORMAT_STRINGS.end() ? pxForm.value() : "Unknown";
+    infoPoints << u"Pixel Format: "_s + pxFormStr;
+    infoPoints << u"Texture Type: "_s + TEXTURE_TYPE_STRINGS[header.textureType()];
+    infoPoints << u"Unknown Flag 1: "_s + (header.flagOne() ? "true" : "false");
+    infoPoints << u"Unknown Flag 2: "_s + (header.flagTwo() ? "true" : "false");
+    infoPoints << u"Mip Maps: "_s + QString::number(mipMaps.count());
+
+    for(const auto& mm : mipMaps)
+        infoPoints << u"  - "_s + (u"%1 x %2"_s).arg(mm.width).arg(mm.height);
+
+    if(indent)
+    {
+        for(auto& ip : infoPoints)
+            ip.prepend(u"  "_s);
+    }
+
+    return infoPoints.join('\n');
+}
+
 //===============================================================================================================
 // K_TEX
 //===============================================================================================================
@@ -85,7 +235,8 @@ void KTex::MipMapImage::setImageDataSize(quint32 size) { mImageData.resize(size)
 //-Constructor-------------------------------------------------------------------------------------------------
 KTex::KTex() :
     mHeader(),
-    mMipMaps()
+    mMipMaps(),
+    mMappedSource()
 {}
 
 //-Class Functions---------------------------------------------------------------------------------------------------
@@ -136,6 +287,59 @@ bool KTex::supportedTextureType(quint8 textureTypeVal)
     }
 }
 
+quint16 KTex::standardPitch(Header::PixelFormat pixelFormat, quint16 width)
+{
+    // One row of pixels for uncompressed formats, one row of 4x4 blocks for compressed formats
+    switch(pixelFormat)
+    {
+        using enum Header::PixelFormat;
+
+        case RGB:
+            return ((width * 3 + 3) / 4) * 4; // QImage rows are 32-bit aligned
+
+        case RGBA:
+            return width * 4;
+
+        case DXT1:
+            return ((width + 3) / 4) * 8;
+
+        case DXT3:
+        case DXT5:
+        case ETC2EAC:
+            return ((width + 3) / 4) * 16;
+
+        default:
+            return 0;
+    }
+}
+
+quint32 KTex::standardImageDataSize(Header::PixelFormat pixelFormat, quint16 width, quint16 height)
+{
+    bool isCompressed = pixelFormat != Header::PixelFormat::RGB && pixelFormat != Header::PixelFormat::RGBA;
+    quint32 rows = isCompressed ? (height + 3) / 4 : height;
+    return standardPitch(pixelFormat, width) * rows;
+}
+
+KTex::Info KTex::expectedMetadata(const Header& header, const QList<QSize>& mipMapSizes)
+{
+    Info info;
+    info.header = header;
+    info.mipMaps.reserve(mipMapSizes.count());
+
+    // Data follows the header and metadata table in order
+    qint64 dataOffset = Header::BYTE_COUNT + mipMapSizes.count() * MipMapImage::METADATA_BYTE_COUNT;
+    for(const QSize& size : mipMapSizes)
+    {
+        quint16 width = size.width();
+        quint16 height = size.height();
+        quint32 dataSize = standardImageDataSize(header.pixelFormat(), width, height);
+        info.mipMaps.append(MipMapInfo{width, height, standardPitch(header.pixelFormat(), width), dataSize, dataOffset});
+        dataOffset += dataSize;
+    }
+
+    return info;
+}
+
 //-Instance Functions--------------------------------------------------------------------------------------------
 //Public:
 KTex::Header& KTex::header() { return mHeader; }
@@ -144,27 +348,23 @@ quint8 KTex::mipMapCount() const { return mMipMaps.count(); }
 bool KTex::hasMipMaps() const { return !mMipMaps.isEmpty(); }
 QVector<KTex::MipMapImage>& KTex::mipMaps() { return mMipMaps; }
 const QVector<KTex::MipMapImage>& KTex::mipMaps() const { return mMipMaps; }
+bool KTex::isMapped() const { return static_cast<bool>(mMappedSource); }
 
-QString KTex::info(bool indent) const
+KTex::Info KTex::metadata() const
 {
-    QStringList infoPoints;
-    infoPoints << u"Platform: "_s + PLATFORM_STRINGS[mHeader.platform()];
-    auto pxForm = PIXEL_FORMAT_STRINGS.find(mHeader.pixelFormat());
-    QString pxFormStr = pxForm != PIXEL_FORMAT_STRINGS.end() ? pxForm.value() : "Unknown";
-    infoPoints << u"Pixel Format: "_s + pxFormStr;
-    infoPoints << u"Texture Type: "_s + TEXTURE_TYPE_STRINGS[mHeader.textureType()];
-    infoPoints << u"Unknown Flag 1: "_s + (mHeader.flagOne() ? "true" : "false");
-    infoPoints << u"Unknown Flag 2: "_s + (mHeader.flagTwo() ? "true" : "false");
-    infoPoints << u"Mip Maps: "_s + QString::number(mMipMaps.count());
+    Info info;
+    info.header = mHeader;
+    info.mipMaps.reserve(mMipMaps.count());
 
+    // Data follows the header and metadata table in order
+    qint64 dataOffset = Header::BYTE_COUNT + mMipMaps.count() * MipMapImage::METADATA_BYTE_COUNT;
     for(const auto& mm : mMipMaps)
-        infoPoints << u"  - "_s + (u"%1 x %2"_s).arg(mm.width()).arg(mm.height());
-
-    if(indent)
     {
-        for(auto& ip : infoPoints)
-            ip.prepend(u"  "_s);
+        info.mipMaps.append(MipMapInfo{mm.width(), mm.height(), mm.pitch(), mm.imageDataSize(), dataOffset});
+        dataOffset += mm.imageDataSize();
     }
 
-    return infoPoints.join('\n');
+    return info;
 }
+
+QString KTex::info(bool indent) const { return metadata().toString(indent); }
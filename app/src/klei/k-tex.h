@@ -5,11 +5,17 @@
 #include <QString>
 #include <QVector>
 #include <QHash>
+#include <QSize>
+
+// Standard Library Includes
+#include <memory>
 
 using namespace Qt::Literals::StringLiterals;
 
 class KTex
 {
+    friend class KTexReader;
+
 //-Inner Classes----------------------------------------------------------------------------------------------------
 public:
     class Header
@@ -56,6 +62,8 @@ public:
         static const int BL_FLAG_AC = 1;
         static const int BL_PADDING_AC = 12;
 
+        static const int BYTE_COUNT = 8; // Magic number + specifications
+
     //-Instance Members------------------------------------------------------------------------------------------------
     private:
         Platform mPlatform;
@@ -87,6 +95,7 @@ public:
     {
     //-Class Members-------------------------------------------------------------------------------------------------
     public:
+        static const int METADATA_BYTE_COUNT = 10; // Width + height + pitch + data size
 
     //-Instance Members------------------------------------------------------------------------------------------------
     private:
@@ -107,6 +116,7 @@ public:
         quint32 imageDataSize() const;
         QByteArray& imageData();
         const QByteArray& imageData() const;
+        QString dataHash() const; // XXH64 of the image data, in hex
         QByteArray jsonMetadata() const;
 
         void setWidth(quint16 width);
@@ -115,6 +125,25 @@ public:
         void setImageDataSize(quint32 size);
     };
 
+    struct MipMapInfo
+    {
+        quint16 width;
+        quint16 height;
+        quint16 pitch;
+        quint32 dataSize;
+        qint64 dataOffset; // From the start of the file
+
+        QByteArray jsonMetadata() const;
+    };
+
+    struct Info
+    {
+        Header header;
+        QVector<MipMapInfo> mipMaps;
+
+        QString toString(bool indent = false) const;
+    };
+
 //-Class Members----------------------------------------------------------------------------------------------------
 private:
     static inline const QHash<Header::Platform, QString> PLATFORM_STRINGS = {
@@ -141,6 +170,7 @@ private:
 private:
     Header mHeader;
     QVector<MipMapImage> mMipMaps;
+    std::shared_ptr<const void> mMappedSource; // Keeps mip-map data that views a file mapping or buffer valid
 
 //-Constructor-------------------------------------------------------------------------------------------------------
 public:
@@ -152,6 +182,9 @@ public:
     static bool supportedPlatform(quint8 platformVal);
     static bool supportedPixelFormat(quint8 pixelFormatVal);
     static bool supportedTextureType(quint8 textureTypeVal);
+    static quint16 standardPitch(Header::PixelFormat pixelFormat, quint16 width);
+    static quint32 standardImageDataSize(Header::PixelFormat pixelFormat, quint16 width, quint16 height);
+    static Info expectedMetadata(const Header& header, const QList<QSize>& mipMapSizes);
 
 //-Instance Functions----------------------------------------------------------------------------------------------
 public:
@@ -161,7 +194,9 @@ public:
     bool hasMipMaps() const;
     QVector<MipMapImage>& mipMaps();
     const QVector<MipMapImage>& mipMaps() const;
+    bool isMapped() const;
 
+    Info metadata() const;
     QString info(bool indent = false) const;
 
 };